@@ -29,6 +29,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <pthread.h>
 
 #include "big_int.h"
 #include "big_int_rand.h"
@@ -72,7 +73,13 @@
 
 /* memory pool for contain big integers */
 #include "big_int_mem_pool.h"
+/* reduction contexts for repeated moduli */
+#include "big_int_barrett.h"
+#include "big_int_ctx_cache.h"
+#include "big_int_powm.h"
 static mem_pool_t *big_num_pool = NULL;
+/* the pool is shared by all threads */
+static pthread_mutex_t big_num_pool_lock = PTHREAD_MUTEX_INITIALIZER;
 
 static inline int hbidx_16(unsigned int value);
 static inline int hbidx_32(unsigned int value);
@@ -88,6 +95,8 @@ int big_int_mem_pool_initialize(size_t size)
 int big_int_mem_pool_uninitialize(void)
 {
     int ret;
+    /* cached contexts may live in the pool */
+    big_int_ctx_cache_clear();
     ret = mem_pool_destroy(big_num_pool);
     big_num_pool = NULL;
     return ret;
@@ -99,7 +108,9 @@ inline static void *__big_int_mem_pool_malloc(size_t size, int *in_pool)
     *in_pool = 0;
     if ((big_num_pool != NULL) && (size <= PAGE_SIZE))
     {
+        pthread_mutex_lock(&big_num_pool_lock);
         p = mem_pool_malloc(big_num_pool, size);
+        pthread_mutex_unlock(&big_num_pool_lock);
         if (p != NULL)
         {
             *in_pool = 1;
@@ -120,7 +131,9 @@ inline static int __big_int_mem_pool_free(void *p, int in_pool)
 {
     if ((big_num_pool != NULL) && in_pool)
     {
+        pthread_mutex_lock(&big_num_pool_lock);
         mem_pool_free(big_num_pool, p);
+        pthread_mutex_unlock(&big_num_pool_lock);
     }
     else
     {
@@ -178,7 +191,7 @@ big_int_t *big_int_new_from_int(unsigned int value)
 	big_int_t *new_int;
     int bit_length = BIT_PER_QBYTE - 1;
 
-    while ((((value >> bit_length) & 0x1) == 0) && bit_length >= 0) bit_length--;
+    while ((bit_length >= 0) && (((value >> bit_length) & 0x1) == 0)) bit_length--;
     bit_length++;
     new_int = __big_int_new_zero(bit_length);
     if (new_int == NULL) return NULL;
@@ -212,13 +225,15 @@ inline int __trim_tail(slot_t *slot, size_t *slot_length, size_t *bit_length)
 {
     /* OPTIMIZE ME */
     slot_t *slot_p = slot + *slot_length - 1;
-    while ((*slot_length > 0) && (*slot_p == 0))
+    /* zero keeps one slot */
+    while ((*slot_length > 1) && (*slot_p == 0))
     {
         (*slot_length)--;
         slot_p--;
     }
     /*(*slot_length)++;*/
     *bit_length = MUL_SLOT((*slot_length - 1)) + hbidx_32(*slot_p);
+    if (*bit_length == 0) *bit_length = 1;
     return 0;
 }
 
@@ -295,7 +310,7 @@ big_int_t *big_int_new_random(size_t bit_length)
     big_int_t *new_int;
     int idx;
 
-	new_int = __big_int_new(bit_length);
+	new_int = __big_int_new_zero(bit_length);
     if (new_int == NULL) return NULL;
     for (idx = 0; idx < (signed int)new_int->slot_length; idx++)
     {
@@ -307,20 +322,8 @@ big_int_t *big_int_new_random(size_t bit_length)
         }
         bit_length -= BIT_PER_SLOT;
     }
-    for (idx = new_int->slot_length - 1; idx >= 0; idx--)
-    {
-        if (new_int->slot[idx] != 0)
-        {
-            new_int->bit_length -= BIT_PER_SLOT - hbidx_32(new_int->slot[idx]);
-            break;
-        }
-        else new_int->slot_length--;
-    }
-    if (new_int->bit_length == 0) 
-    {
-        new_int->slot_length = 1;
-        new_int->bit_length = 1;
-    }
+    /* the length follows the highest set bit, not the requested one */
+    __big_int_normalize(new_int);
     return new_int;
 }
 
@@ -476,8 +479,8 @@ int big_int_add_to_raw(big_int_t *num1, big_int_t *num2)
 
     neccessary_bit = MAX(num1->bit_length, num2->bit_length) + 1;
     neccessary_slot = BIT_TO_SLOT(neccessary_bit);
-    /* allocated space size check */
-    if (neccessary_slot > num1->allocated_slot_length)
+    /* allocated space size check (the carry slot is always written) */
+    if (neccessary_slot >= num1->allocated_slot_length)
     {
         /* allocate space for new slot */
         new_slot = (slot_t *)__big_int_mem_pool_malloc(sizeof(slot_t) * (neccessary_slot + ALLOCATE_SLOT_SIZE), &new_in_pool);
@@ -500,7 +503,9 @@ int big_int_add_to_raw(big_int_t *num1, big_int_t *num2)
     carry = 0;
     for (slot_idx = 0; slot_idx < (signed int)operation_slot_length; slot_idx++)
     {
-        tmp = (uint64_t)(num1->slot[slot_idx]) + num2->slot[slot_idx] + carry;
+        /* num2 may be shorter than its allocated space */
+        tmp = (uint64_t)(num1->slot[slot_idx]) + carry;
+        if (slot_idx < (signed int)num2->slot_length) tmp += num2->slot[slot_idx];
         carry = tmp >> BIT_PER_SLOT;
         num1->slot[slot_idx] = tmp & BIT_MASK_SLOT;
     }
@@ -565,7 +570,7 @@ int big_int_sub_to_raw(big_int_t *num1, big_int_t *num2)
         }
     }
     slot_idx = num1->slot_length - 1;
-    while (num1->slot[slot_idx] == 0 && slot_idx >= 0) {slot_idx--;}
+    while (slot_idx >= 0 && num1->slot[slot_idx] == 0) {slot_idx--;}
     if (slot_idx == -1)
     {
         /* result = 0 */
@@ -843,67 +848,85 @@ fail:
     return w;
 }
 
-inline big_int_t *__big_int_mul_plain(big_int_t *num1, big_int_t *num2)
+/* r[0..n-1] += a[0..n-1] * b, returns the carry slot */
+slot_t __big_int_slots_addmul_1(slot_t *r, const slot_t *a, size_t n, slot_t b)
 {
-    big_int_t *num_term, *num_final;
-    int num1_slot_idx, num2_slot_idx, num_term_slot_idx;
-    int num_term_slot_idx_max; /* the maximum value of term value on last calculation, for cleaning the term */
-    unsigned int neccessary_bit;
-    unsigned int carry;
+    size_t i;
     uint64_t tmp;
+    slot_t carry = 0;
 
-    /* squaring */
-    if (num1 == num2) 
+    for (i = 0; i != n; i++)
     {
-        return __big_int_square_plain(num1);
+        /* (2^32 - 1)^2 + 2 * (2^32 - 1) fits in 64 bits */
+        tmp = (uint64_t)a[i] * b + r[i] + carry;
+        r[i] = (slot_t)tmp;
+        carry = (slot_t)(tmp >> BIT_PER_SLOT);
     }
+    return carry;
+}
 
-    /* create new int for containing then result */
-    neccessary_bit = num1->bit_length + num2->bit_length;
-    num_term = __big_int_new_zero(neccessary_bit);
-    if (num_term == NULL) return NULL;
-    num_final = big_int_new_from_int(0);
-    if (num_final == NULL) 
-    {
-        big_int_destroy(num_term);
-        return NULL;
-    }
-    num_term_slot_idx_max = 0;
-    /* multiply Operation */
-    for (num1_slot_idx = 0; num1_slot_idx != (signed int)num1->slot_length; num1_slot_idx++)
-    {
-        /* clear term */
-        for (num_term_slot_idx = 0; num_term_slot_idx != num_term_slot_idx_max; num_term_slot_idx++)
-            num_term->slot[num_term_slot_idx] = 0;
+/* r[0..an+bn-1] = a[0..an-1] * b[0..bn-1], r must not overlap a or b */
+void __big_int_slots_mul(slot_t *r, const slot_t *a, size_t an, const slot_t *b, size_t bn)
+{
+    size_t i;
 
-        if (num1->slot[num1_slot_idx] != 0)
-        {
-            carry = 0;
-            num_term_slot_idx = num1_slot_idx;
-            for (num2_slot_idx = 0; num2_slot_idx != (signed int)num2->slot_length; num2_slot_idx++, num_term_slot_idx++)
-            {
-                tmp = (uint64_t)num1->slot[num1_slot_idx] * num2->slot[num2_slot_idx] + carry;
-                carry = tmp >> BIT_PER_SLOT;
-                num_term->slot[num_term_slot_idx] = tmp & 0xFFFFFFFF;
-            }
-            num_term->slot_length = num_term_slot_idx;
+    for (i = 0; i != bn; i++) r[i] = 0;
+    for (i = 0; i != an; i++)
+        r[i + bn] = __big_int_slots_addmul_1(r + i, b, bn, a[i]);
+}
 
-            num_term->slot[num_term_slot_idx] = carry;
-            num_term->slot_length += !(!carry); /* need one more slot if carry greater then zero */
-            num_term->bit_length = MUL_SLOT(num_term->slot_length - 1) + hbidx_32(num_term->slot[num_term->slot_length - 1]);
+/* r[0..2n-1] = a[0..n-1]^2, r must not overlap a */
+void __big_int_slots_sqr(slot_t *r, const slot_t *a, size_t n)
+{
+    size_t i;
+    uint64_t tmp;
+    slot_t carry, shift_in, low, high;
 
-            num_term_slot_idx_max = num_term->slot_length;
-            /* Add term into final */
-            if (big_int_add_to(num_final, num_term) != 0)
-            {
-                big_int_destroy(num_term);
-                big_int_destroy(num_final);
-                return NULL;
-            }
-        }
+    for (i = 0; i != (n << 1); i++) r[i] = 0;
+    /* cross products a[i] * a[j] with i < j, counted once */
+    for (i = 0; i + 1 < n; i++)
+        r[i + n] = __big_int_slots_addmul_1(r + (i << 1) + 1, a + i + 1, n - i - 1, a[i]);
+    /* double them and add the squares on the diagonal */
+    carry = 0;
+    shift_in = 0;
+    for (i = 0; i != n; i++)
+    {
+        low = r[i << 1];
+        high = r[(i << 1) + 1];
+        tmp = (uint64_t)a[i] * a[i] + (slot_t)((low << 1) | shift_in) + carry;
+        r[i << 1] = (slot_t)tmp;
+        tmp = (tmp >> BIT_PER_SLOT) + (slot_t)((high << 1) | (low >> (BIT_PER_SLOT - 1)));
+        r[(i << 1) + 1] = (slot_t)tmp;
+        carry = (slot_t)(tmp >> BIT_PER_SLOT);
+        shift_in = high >> (BIT_PER_SLOT - 1);
     }
+}
 
-    big_int_destroy(num_term);
+inline big_int_t *__big_int_mul_plain(big_int_t *num1, big_int_t *num2)
+{
+    big_int_t *num_final;
+    size_t num1_slot_idx;
+
+    /* squaring */
+    if (num1 == num2) 
+    {
+        return __big_int_square_plain(num1);
+    }
+
+    /* create new int for containing then result (the carry of the
+     * last term takes one slot beyond the two operands) */
+    num_final = __big_int_new_zero(MUL_SLOT(num1->slot_length + num2->slot_length));
+    if (num_final == NULL) return NULL;
+
+    /* multiply Operation, each term is accumulated in place */
+    for (num1_slot_idx = 0; num1_slot_idx != num1->slot_length; num1_slot_idx++)
+    {
+        if (num1->slot[num1_slot_idx] == 0) continue;
+        num_final->slot[num1_slot_idx + num2->slot_length] = __big_int_slots_addmul_1( \
+                num_final->slot + num1_slot_idx, num2->slot, num2->slot_length, num1->slot[num1_slot_idx]);
+    }
+    num_final->slot_length = num1->slot_length + num2->slot_length;
+    __big_int_normalize(num_final);
 
     /* Reture result */
     return num_final;
@@ -970,6 +993,54 @@ fail:
     return ret;
 }
 
+/* x * y for y more than twice as long as x, the pieces of y are
+ * multiplied by x one by one and summed in place */
+static big_int_t *__big_int_mul_unbalanced(big_int_t *x, big_int_t *y)
+{
+    big_int_t *result, *piece = NULL, *product = NULL;
+    size_t offset, slot_idx, piece_length = x->slot_length;
+    uint64_t carry;
+
+    result = __big_int_new_zero(MUL_SLOT(x->slot_length + y->slot_length + 1));
+    if (result == NULL) return NULL;
+    for (offset = 0; offset < y->slot_length; offset += piece_length)
+    {
+        piece_length = MIN(x->slot_length, y->slot_length - offset);
+        if ((piece = __big_int_new_zero(MUL_SLOT(piece_length))) == NULL) goto fail;
+        for (slot_idx = 0; slot_idx != piece_length; slot_idx++) piece->slot[slot_idx] = y->slot[offset + slot_idx];
+        piece->slot_length = piece_length;
+        __big_int_normalize(piece);
+        if (big_int_is_zero(piece))
+        {
+            big_int_destroy(piece); piece = NULL;
+            continue;
+        }
+        if ((product = __big_int_mul_without_check(x, piece)) == NULL) goto fail;
+        carry = 0;
+        for (slot_idx = 0; slot_idx != product->slot_length; slot_idx++)
+        {
+            carry += (uint64_t)result->slot[offset + slot_idx] + product->slot[slot_idx];
+            result->slot[offset + slot_idx] = (slot_t)carry;
+            carry >>= BIT_PER_SLOT;
+        }
+        for (slot_idx += offset; carry != 0; slot_idx++)
+        {
+            carry += result->slot[slot_idx];
+            result->slot[slot_idx] = (slot_t)carry;
+            carry >>= BIT_PER_SLOT;
+        }
+        big_int_destroy(piece); piece = NULL;
+        big_int_destroy(product); product = NULL;
+    }
+    result->slot_length = x->slot_length + y->slot_length;
+    __big_int_normalize(result);
+    return result;
+fail:
+    if (piece != NULL) big_int_destroy(piece);
+    big_int_destroy(result);
+    return NULL;
+}
+
 /* Karatsuba multiplication 
  * Described in http://en.wikipedia.org/wiki/Karatsuba_algorithm 
  */
@@ -986,10 +1057,11 @@ inline big_int_t *__big_int_mul_karatsuba(big_int_t *num1, big_int_t *num2)
     if (num1->bit_length > num2->bit_length) {x = num2; y = num1;}
     else {x= num1; y= num2;}
 
-    /* Multiplicand is too shorter, use plain multipliy instead */
+    /* Multiplicand is too shorter, multiply it with pieces of the
+     * multiplier of its own length instead */
     if ((x->bit_length << 1) < y->bit_length)
     {
-        return __big_int_mul_plain(num1, num2);
+        return __big_int_mul_unbalanced(x, y);
     }
 
     /* Split high and low part */
@@ -1074,7 +1146,7 @@ fail:
  *   ----------------------^          -> mul_karatsuba */
 
 /* mul function invoked by mul_to without check (check has been done by mul_to) */
-#define BIG_NUMBER_MUL_KARATSUBA_THRESHOLD 768
+#define BIG_NUMBER_MUL_KARATSUBA_THRESHOLD 6144
 inline big_int_t *__big_int_mul_without_check(big_int_t *num1, big_int_t *num2)
 {
     int sign = (num1->sign == num2->sign) ? BIG_NUMBER_POSITIVE : BIG_NUMBER_NEGATIVE;
@@ -1101,6 +1173,8 @@ inline big_int_t *__big_int_mul_without_check(big_int_t *num1, big_int_t *num2)
 /* Multiplication interface 1 */
 big_int_t *big_int_mul(big_int_t *num1, big_int_t *num2)
 {
+    big_int_t *num_final;
+
     if (num1->slot_length == 1 && num1->slot[0] == 0)
     {
         /* 0 * X = 0 */
@@ -1108,13 +1182,17 @@ big_int_t *big_int_mul(big_int_t *num1, big_int_t *num2)
     }
     else if (num1->slot_length == 1 && num1->slot[0] == 1)
     {
-        /* 1 * X == X */
-        return big_int_assign(num2);
+        /* 1 * X == X, -1 * X == -X */
+        num_final = big_int_assign(num2);
+        if ((num_final != NULL) && !big_int_is_zero(num_final)) num_final->sign = num1->sign ^ num2->sign;
+        return num_final;
     }
     else if (num2->slot_length == 1 && num2->slot[0] == 1)
     {
-        /* X * 1 == X */
-        return big_int_assign(num1);
+        /* X * 1 == X, X * -1 == -X */
+        num_final = big_int_assign(num1);
+        if (num_final != NULL) num_final->sign = num1->sign ^ num2->sign;
+        return num_final;
     }
     else if (num2->slot_length == 1 && num2->slot[0] == 0)
     {
@@ -1203,6 +1281,8 @@ int big_int_left_shift(big_int_t *num, int bit_length)
     int dst_in_pool;
     int slot_idx;
     unsigned int slot_delta, bit_delta, neccessary_bit, neccessary_slot;
+    /* 0 << n = 0, no zero slots on top */
+    if (big_int_is_zero(num)) return 0;
     neccessary_bit = num->bit_length + bit_length;
     neccessary_slot = BIT_TO_SLOT(neccessary_bit);
     if (neccessary_slot >= num->allocated_slot_length) 
@@ -1267,23 +1347,573 @@ int big_int_right_shift(big_int_t *num, int bit_length)
         {
             num->slot[slot_idx] = 0;
         }
-        num->slot_length -= slot_delta;
-        num->bit_length -= MUL_SLOT(slot_delta);
-        if (num->slot_length == 0) num->slot_length = 1;
+        num->slot_length = (num->slot_length > slot_delta) ? num->slot_length - slot_delta : 1;
     }
     if (bit_delta > 0)
     {
-        for (slot_idx = 0; slot_idx != (signed int)num->slot_length; slot_idx++)
+        /* the top slot takes zeros, the slot above it may lie past
+         * the allocation */
+        for (slot_idx = 0; slot_idx + 1 < (signed int)num->slot_length; slot_idx++)
         {
             num->slot[slot_idx] = (num->slot[slot_idx] >> bit_delta) |\
                                   ((num->slot[slot_idx + 1] & ((1 << bit_delta) - 1)) << (BIT_PER_SLOT - bit_delta));
         }
+        num->slot[slot_idx] >>= bit_delta;
+    }
+    __big_int_normalize(num);
+    return 0;
+}
+
+/* internal use only */
+/* make sure the int could hold 'slot_length' slots,
+ * slots beyond the used part are kept zero */
+int __big_int_reserve(big_int_t *num, size_t slot_length)
+{
+    slot_t *new_slot;
+    int new_in_pool;
+    size_t slot_idx;
+
+    if (slot_length <= num->allocated_slot_length) return 0;
+    new_slot = (slot_t *)__big_int_mem_pool_malloc(sizeof(slot_t) * (slot_length + ALLOCATE_SLOT_SIZE), &new_in_pool);
+    if (new_slot == NULL) return -1;
+    for (slot_idx = 0; slot_idx < num->slot_length; slot_idx++) new_slot[slot_idx] = num->slot[slot_idx];
+    if (new_in_pool == 0)
+    {
+        for (; slot_idx < slot_length + ALLOCATE_SLOT_SIZE; slot_idx++) new_slot[slot_idx] = 0;
     }
-    if (num->slot[num->slot_length - 1] == 0 && num->slot_length > 0) num->slot_length--;
+    __big_int_clean_slots(num->slot, num->slot_length);
+    __big_int_mem_pool_free(num->slot, num->in_pool);
+    num->slot = new_slot;
+    num->in_pool = new_in_pool;
+    num->allocated_slot_length = slot_length + ALLOCATE_SLOT_SIZE;
+    return 0;
+}
+
+/* internal use only */
+/* drop the leading zero slots and update the bit length */
+void __big_int_normalize(big_int_t *num)
+{
+    while (num->slot_length > 1 && num->slot[num->slot_length - 1] == 0) num->slot_length--;
+    if (num->slot_length == 0) num->slot_length = 1;
     num->bit_length = MUL_SLOT(num->slot_length - 1) + hbidx_32(num->slot[num->slot_length - 1]);
+    if (num->bit_length == 0)
+    {
+        num->bit_length = 1;
+        num->sign = BIG_NUMBER_POSITIVE;
+    }
+}
+
+/* internal use only */
+/* hand over the slots of 'src' to 'dst' and release 'src' */
+void __big_int_move_to(big_int_t *dst, big_int_t *src)
+{
+    __big_int_clean_slots(dst->slot, dst->slot_length);
+    __big_int_mem_pool_free(dst->slot, dst->in_pool);
+    dst->slot = src->slot;
+    dst->allocated_slot_length = src->allocated_slot_length;
+    dst->bit_length = src->bit_length;
+    dst->slot_length = src->slot_length;
+    dst->sign = src->sign;
+    dst->in_pool = src->in_pool;
+    free(src);
+}
+
+/* Divide u[0..m-1] by a single slot, quotient to q[0..m-1],
+ * return the remainder */
+slot_t __big_int_slots_divrem_1(slot_t *q, const slot_t *u, size_t m, slot_t v)
+{
+    uint64_t rem = 0, tmp;
+    size_t slot_idx = m;
+
+    while (slot_idx-- > 0)
+    {
+        tmp = (rem << BIT_PER_SLOT) | u[slot_idx];
+        if (q != NULL) q[slot_idx] = (slot_t)(tmp / v);
+        rem = tmp % v;
+    }
+    return (slot_t)rem;
+}
+
+/* Long division of u[0..m-1] by v[0..n-1] (m >= n >= 2, v[n-1] != 0)
+ * with one quotient slot per step, Algorithm D described in
+ * <<The Art of Computer Programming>> Volume 2, Chapter 4.3.1
+ * q takes (m - n + 1) slots, r takes n slots (could be NULL),
+ * un takes (m + 1) slots and vn takes n slots as scratch */
+void __big_int_slots_divrem(slot_t *q, slot_t *r, \
+        const slot_t *u, size_t m, const slot_t *v, size_t n, \
+        slot_t *un, slot_t *vn)
+{
+    int s;
+    size_t i;
+    long j;
+    uint64_t num, qhat, rhat, p;
+    int64_t t, k;
+
+    /* Normalize, make the highest bit of divisor set */
+    s = BIT_PER_SLOT - hbidx_32(v[n - 1]);
+    for (i = n - 1; i > 0; i--)
+        vn[i] = (v[i] << s) | (s ? (v[i - 1] >> (BIT_PER_SLOT - s)) : 0);
+    vn[0] = v[0] << s;
+    un[m] = s ? (u[m - 1] >> (BIT_PER_SLOT - s)) : 0;
+    for (i = m - 1; i > 0; i--)
+        un[i] = (u[i] << s) | (s ? (u[i - 1] >> (BIT_PER_SLOT - s)) : 0);
+    un[0] = u[0] << s;
+
+    for (j = (long)(m - n); j >= 0; j--)
+    {
+        /* Estimate quotient slot from the top two slots */
+        num = ((uint64_t)un[j + n] << BIT_PER_SLOT) | un[j + n - 1];
+        qhat = num / vn[n - 1];
+        rhat = num - qhat * vn[n - 1];
+        while ((qhat >> BIT_PER_SLOT) != 0 || \
+                qhat * vn[n - 2] > ((rhat << BIT_PER_SLOT) | un[j + n - 2]))
+        {
+            qhat--;
+            rhat += vn[n - 1];
+            if ((rhat >> BIT_PER_SLOT) != 0) break;
+        }
+        /* Multiply and subtract */
+        k = 0;
+        for (i = 0; i < n; i++)
+        {
+            p = qhat * vn[i];
+            t = (int64_t)un[i + j] - k - (int64_t)(p & BIT_MASK_SLOT);
+            un[i + j] = (slot_t)t;
+            k = (int64_t)(p >> BIT_PER_SLOT) - (t >> BIT_PER_SLOT);
+        }
+        t = (int64_t)un[j + n] - k;
+        un[j + n] = (slot_t)t;
+        q[j] = (slot_t)qhat;
+        /* Estimation was one too large, add back */
+        if (t < 0)
+        {
+            q[j]--;
+            k = 0;
+            for (i = 0; i < n; i++)
+            {
+                t = (int64_t)un[i + j] + vn[i] + k;
+                un[i + j] = (slot_t)t;
+                k = t >> BIT_PER_SLOT;
+            }
+            un[j + n] += (slot_t)k;
+        }
+    }
+    /* Unnormalize remainder */
+    if (r != NULL)
+    {
+        for (i = 0; i < n - 1; i++)
+            r[i] = (un[i] >> s) | (s ? (un[i + 1] << (BIT_PER_SLOT - s)) : 0);
+        r[n - 1] = un[n - 1] >> s;
+    }
+}
+
+/* Newton iteration division for huge operands
+ * 
+ * 1/D is found by Newton's method y' = y + y * (1 - D * y),
+ * the precision doubles on each step, so building the reciprocal
+ * from half precision costs about two multiplications of the
+ * final size, and the quotient itself another two.
+ * The long division loop is fast enough to win below about
+ * a hundred thousand bits of quotient and divisor. */
+#define BIG_NUMBER_DIV_NEWTON_THRESHOLD 98304
+#define BIG_NUMBER_DIV_NEWTON_BASE 12288
+#define BIG_NUMBER_DIV_NEWTON_GUARD 32
+
+static int __big_int_divrem_newton(big_int_t **q_out, big_int_t **r_out, big_int_t *a, big_int_t *b);
+
+/* Divide the value part of a by b (ignore sign),
+ * both quotient and remainder are positive */
+static int __big_int_divrem_raw(big_int_t **q_out, big_int_t **r_out, big_int_t *a, big_int_t *b)
+{
+    int ret = -1;
+    size_t m = a->slot_length, n = b->slot_length;
+    big_int_t *q = NULL, *r = NULL;
+    slot_t *un = NULL, *vn = NULL;
+
+    if (big_int_is_zero(b)) return -1;
+    if (big_int_compare_raw(a, b) < 0)
+    {
+        /* min / max = 0, min % max = min */
+        q = big_int_new_from_int(0);
+        r = big_int_assign(a);
+        if (q == NULL || r == NULL) goto fail;
+        r->sign = BIG_NUMBER_POSITIVE;
+    }
+    else if (MIN(a->bit_length - b->bit_length + 1, b->bit_length) > BIG_NUMBER_DIV_NEWTON_THRESHOLD)
+    {
+        /* Huge operands, use reciprocal */
+        return __big_int_divrem_newton(q_out, r_out, a, b);
+    }
+    else if (n == 1)
+    {
+        q = __big_int_new_zero(MUL_SLOT(m));
+        if (q == NULL) goto fail;
+        r = big_int_new_from_int(__big_int_slots_divrem_1(q->slot, a->slot, m, b->slot[0]));
+        if (r == NULL) goto fail;
+    }
+    else
+    {
+        q = __big_int_new_zero(MUL_SLOT(m - n + 1));
+        r = __big_int_new_zero(MUL_SLOT(n));
+        un = (slot_t *)malloc(sizeof(slot_t) * (m + 1));
+        vn = (slot_t *)malloc(sizeof(slot_t) * n);
+        if (q == NULL || r == NULL || un == NULL || vn == NULL) goto fail;
+        __big_int_slots_divrem(q->slot, r->slot, a->slot, m, b->slot, n, un, vn);
+    }
+    __big_int_normalize(q);
+    __big_int_normalize(r);
+    *q_out = q; q = NULL;
+    *r_out = r; r = NULL;
+    ret = 0;
+fail:
+    if (q != NULL) big_int_destroy(q);
+    if (r != NULL) big_int_destroy(r);
+    if (un != NULL) free(un);
+    if (vn != NULL) free(vn);
+    return ret;
+}
+
+/* internal use only */
+/* set the int to zero */
+static void __big_int_set_zero(big_int_t *num)
+{
+    __big_int_clean_slots(num->slot, num->slot_length);
+    num->slot_length = 1;
+    num->bit_length = 1;
+    num->sign = BIG_NUMBER_POSITIVE;
+}
+
+/* internal use only */
+/* shift the value part of a copy of num to make it 'bit_length' bits */
+static big_int_t *__big_int_assign_with_length(big_int_t *num, size_t bit_length)
+{
+    big_int_t *new_num = big_int_assign(num);
+
+    if (new_num == NULL) return NULL;
+    new_num->sign = BIG_NUMBER_POSITIVE;
+    if (num->bit_length > bit_length)
+        big_int_right_shift(new_num, num->bit_length - bit_length);
+    else if (num->bit_length < bit_length)
+        big_int_left_shift(new_num, bit_length - num->bit_length);
+    return new_num;
+}
+
+/* Approximate 2^(2p) / D, D is the highest p bits of b */
+static big_int_t *__big_int_reciprocal(big_int_t *b, size_t p)
+{
+    size_t p_half;
+    int sign;
+    big_int_t *d = NULL, *e = NULL, *t = NULL, *y = NULL, *r = NULL;
+
+    if ((d = __big_int_assign_with_length(b, p)) == NULL) goto fail;
+    if ((e = big_int_new_from_int(1)) == NULL) goto fail;
+    if (big_int_left_shift(e, p << 1) != 0) goto fail;
+    if (p <= BIG_NUMBER_DIV_NEWTON_BASE)
+    {
+        /* Short enough for long division */
+        if (__big_int_divrem_raw(&y, &r, e, d) != 0) goto fail;
+        goto done;
+    }
+
+    /* y = reciprocal in half precision, Y = y * 2^(p - p_half) */
+    p_half = (p >> 1) + BIG_NUMBER_DIV_NEWTON_GUARD;
+    if ((y = __big_int_reciprocal(b, p_half)) == NULL) goto fail;
+
+    /* Y' = Y + Y * (2^(2p) - D * Y) / 2^(2p)
+     *    = Y + y * E / 2^(2 * p_half), E = 2^(p + p_half) - D * y,
+     * only the high bits of E are needed for p bits of precision */
+    big_int_right_shift(e, p - p_half);
+    if ((t = big_int_mul(d, y)) == NULL) goto fail;
+    if (big_int_sub_to(e, t) != 0) goto fail;
+    sign = e->sign;
+    e->sign = BIG_NUMBER_POSITIVE;
+    if (e->bit_length <= p - p_half) __big_int_set_zero(e);
+    else big_int_right_shift(e, p - p_half);
+    if (big_int_mul_to(e, y) != 0) goto fail;
+    if (e->bit_length <= 3 * p_half - p) __big_int_set_zero(e);
+    else big_int_right_shift(e, 3 * p_half - p);
+    if (big_int_left_shift(y, p - p_half) != 0) goto fail;
+    if (sign == BIG_NUMBER_POSITIVE) { if (big_int_add_to(y, e) != 0) goto fail; }
+    else { if (big_int_sub_to(y, e) != 0) goto fail; }
+    goto done;
+fail:
+    if (y != NULL) { big_int_destroy(y); y = NULL; }
+done:
+    if (d != NULL) big_int_destroy(d);
+    if (e != NULL) big_int_destroy(e);
+    if (t != NULL) big_int_destroy(t);
+    if (r != NULL) big_int_destroy(r);
+    return y;
+}
+
+/* Division with reciprocal, both quotient and remainder are positive */
+static int __big_int_divrem_newton(big_int_t **q_out, big_int_t **r_out, big_int_t *a, big_int_t *b)
+{
+    int ret = -1;
+    size_t p = a->bit_length - b->bit_length + 1 + BIG_NUMBER_DIV_NEWTON_GUARD;
+    size_t shift;
+    big_int_t *y = NULL, *q = NULL, *r = NULL, *t = NULL, *divisor = NULL, *one = NULL;
+
+    if ((divisor = big_int_assign(b)) == NULL) goto fail;
+    divisor->sign = BIG_NUMBER_POSITIVE;
+    if ((one = big_int_new_from_int(1)) == NULL) goto fail;
+    if ((y = __big_int_reciprocal(divisor, p)) == NULL) goto fail;
+
+    /* q = A * y / 2^(2p + lb - la), A is the highest p bits of a,
+     * the dropped low bits of a move q by less than one unit */
+    if ((q = __big_int_assign_with_length(a, p)) == NULL) goto fail;
+    if (big_int_mul_to(q, y) != 0) goto fail;
+    shift = (p << 1) + divisor->bit_length - a->bit_length;
+    if (q->bit_length <= shift) __big_int_set_zero(q);
+    else big_int_right_shift(q, shift);
+
+    /* r = a - q * b, then fix the few units of error */
+    if ((r = big_int_assign(a)) == NULL) goto fail;
+    r->sign = BIG_NUMBER_POSITIVE;
+    if ((t = big_int_mul(q, divisor)) == NULL) goto fail;
+    if (big_int_sub_to(r, t) != 0) goto fail;
+    while (r->sign == BIG_NUMBER_NEGATIVE)
+    {
+        if (big_int_add_to(r, divisor) != 0) goto fail;
+        if (big_int_sub_to(q, one) != 0) goto fail;
+    }
+    while (big_int_compare(r, divisor) >= 0)
+    {
+        if (big_int_sub_to(r, divisor) != 0) goto fail;
+        if (big_int_add_to(q, one) != 0) goto fail;
+    }
+    *q_out = q; q = NULL;
+    *r_out = r; r = NULL;
+    ret = 0;
+fail:
+    if (y != NULL) big_int_destroy(y);
+    if (q != NULL) big_int_destroy(q);
+    if (r != NULL) big_int_destroy(r);
+    if (t != NULL) big_int_destroy(t);
+    if (divisor != NULL) big_int_destroy(divisor);
+    if (one != NULL) big_int_destroy(one);
+    return ret;
+}
+
+/* Quotient and remainder with a single division pass
+ * q = a / b rounded toward zero, r = a - q * b takes the sign of a,
+ * either q or r could be NULL when not needed */
+int big_int_divrem(big_int_t *q, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    int sign_q = (a->sign == b->sign) ? BIG_NUMBER_POSITIVE : BIG_NUMBER_NEGATIVE;
+    int sign_r = a->sign;
+    big_int_t *quotient = NULL, *remainder = NULL;
+
+    if (__big_int_divrem_raw(&quotient, &remainder, a, b) != 0) return -1;
+    if (!big_int_is_zero(quotient)) quotient->sign = sign_q;
+    if (!big_int_is_zero(remainder)) remainder->sign = sign_r;
+    if (q != NULL) __big_int_move_to(q, quotient); else big_int_destroy(quotient);
+    if (r != NULL) __big_int_move_to(r, remainder); else big_int_destroy(remainder);
+    return 0;
+}
+
+/* Quotient and remainder with a single division pass
+ * q = a / b rounded toward negative infinity, r = a - q * b takes the sign of b,
+ * either q or r could be NULL when not needed */
+int big_int_divrem_floor(big_int_t *q, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    int ret = -1;
+    int sign_q = (a->sign == b->sign) ? BIG_NUMBER_POSITIVE : BIG_NUMBER_NEGATIVE;
+    int sign_b = b->sign;
+    big_int_t *quotient = NULL, *remainder = NULL, *divisor = NULL;
+    big_int_t *one = NULL;
+
+    if (__big_int_divrem_raw(&quotient, &remainder, a, b) != 0) return -1;
+    if ((sign_q == BIG_NUMBER_NEGATIVE) && !big_int_is_zero(remainder))
+    {
+        /* -7 / 2 = -4 ... 1, 7 / -2 = -4 ... -1 */
+        if ((one = big_int_new_from_int(1)) == NULL) goto fail;
+        if (big_int_add_to(quotient, one) != 0) goto fail;
+        if ((divisor = big_int_assign(b)) == NULL) goto fail;
+        divisor->sign = BIG_NUMBER_POSITIVE;
+        if (big_int_sub_to(divisor, remainder) != 0) goto fail;
+        big_int_destroy(remainder);
+        remainder = divisor; divisor = NULL;
+    }
+    if (!big_int_is_zero(quotient)) quotient->sign = sign_q;
+    if (!big_int_is_zero(remainder)) remainder->sign = sign_b;
+    if (q != NULL) { __big_int_move_to(q, quotient); quotient = NULL; }
+    if (r != NULL) { __big_int_move_to(r, remainder); remainder = NULL; }
+    ret = 0;
+fail:
+    if (quotient != NULL) big_int_destroy(quotient);
+    if (remainder != NULL) big_int_destroy(remainder);
+    if (divisor != NULL) big_int_destroy(divisor);
+    if (one != NULL) big_int_destroy(one);
+    return ret;
+}
+
+/* Exact division
+ * 
+ * When b is known to divide a, the quotient can be found from the
+ * lowest slot upward (Jebelean), q[i] = w[i] * (1 / b[0]) mod 2^32,
+ * no quotient estimation and correction as in long division,
+ * only the low slots of the quotient length are ever touched. */
+
+/* internal use only */
+/* r[0..n-1] -= a[0..n-1] * b, returns the borrow slot */
+slot_t __big_int_slots_submul_1(slot_t *r, const slot_t *a, size_t n, slot_t b)
+{
+    size_t i;
+    uint64_t tmp;
+    slot_t low, borrow = 0;
+
+    for (i = 0; i != n; i++)
+    {
+        tmp = (uint64_t)a[i] * b + borrow;
+        low = (slot_t)tmp;
+        borrow = (slot_t)(tmp >> BIT_PER_SLOT) + (r[i] < low);
+        r[i] -= low;
+    }
+    return borrow;
+}
+
+/* internal use only */
+/* inverse of an odd slot modulo 2^32 */
+slot_t __big_int_slot_inverse(slot_t d)
+{
+    /* d * d = 1 (mod 8), each Newton step doubles the correct bits */
+    slot_t inv = d;
+    inv *= 2 - d * inv;
+    inv *= 2 - d * inv;
+    inv *= 2 - d * inv;
+    inv *= 2 - d * inv;
+    return inv;
+}
+
+/* internal use only */
+/* number of trailing zero bits of a non-zero int */
+static size_t __big_int_trailing_zeros(big_int_t *num)
+{
+    size_t slot_idx = 0, bits = 0;
+    slot_t value;
+
+    while (num->slot[slot_idx] == 0) slot_idx++;
+    value = num->slot[slot_idx];
+    while ((value & 1) == 0) { value >>= 1; bits++; }
+    return MUL_SLOT(slot_idx) + bits;
+}
+
+/* Divide the value part of a by b which divides it exactly,
+ * the result is positive */
+static big_int_t *__big_int_divexact_raw(big_int_t *a, big_int_t *b)
+{
+    size_t shift, qn, i, j, len;
+    big_int_t *w = NULL, *d = NULL;
+    slot_t inv, q_slot, borrow, tmp;
+
+    if ((w = big_int_assign(a)) == NULL) goto fail;
+    w->sign = BIG_NUMBER_POSITIVE;
+    if (big_int_is_zero(w)) goto done;
+    if ((d = big_int_assign(b)) == NULL) goto fail;
+    d->sign = BIG_NUMBER_POSITIVE;
+
+    /* make the divisor odd, a has at least as many trailing zeros */
+    shift = __big_int_trailing_zeros(d);
+    if (shift != 0)
+    {
+        big_int_right_shift(d, (int)shift);
+        if (w->bit_length <= shift) { __big_int_set_zero(w); goto done; }
+        big_int_right_shift(w, (int)shift);
+    }
+    if (big_int_compare_raw(w, d) < 0) { __big_int_set_zero(w); goto done; }
+
+    qn = w->slot_length - d->slot_length + 1;
+    inv = __big_int_slot_inverse(d->slot[0]);
+    for (i = 0; i != qn; i++)
+    {
+        /* the slot i becomes zero after subtracting q[i] * d,
+         * anything above the quotient length is dropped */
+        q_slot = w->slot[i] * inv;
+        len = MIN(d->slot_length, qn - i);
+        borrow = __big_int_slots_submul_1(w->slot + i, d->slot, len, q_slot);
+        for (j = i + len; (borrow != 0) && (j != qn); j++)
+        {
+            tmp = w->slot[j];
+            w->slot[j] = tmp - borrow;
+            borrow = (tmp < borrow);
+        }
+        w->slot[i] = q_slot;
+    }
+    __big_int_clean_slots(w->slot + qn, w->slot_length - qn);
+    w->slot_length = qn;
+    __big_int_normalize(w);
+    goto done;
+fail:
+    if (w != NULL) { big_int_destroy(w); w = NULL; }
+done:
+    if (d != NULL) big_int_destroy(d);
+    return w;
+}
+
+/* q = a / b, b must divide a exactly, otherwise the result is undefined */
+int big_int_divexact(big_int_t *q, big_int_t *a, big_int_t *b)
+{
+    int sign_q = (a->sign == b->sign) ? BIG_NUMBER_POSITIVE : BIG_NUMBER_NEGATIVE;
+    big_int_t *quotient;
+
+    if (big_int_is_zero(b)) return -1;
+    if ((quotient = __big_int_divexact_raw(a, b)) == NULL) return -1;
+    if (!big_int_is_zero(quotient)) quotient->sign = sign_q;
+    __big_int_move_to(q, quotient);
+    return 0;
+}
+
+/* q = a / d, d must divide a exactly, otherwise the result is undefined */
+int big_int_divexact_u32(big_int_t *q, big_int_t *a, uint32_t d)
+{
+    int sign_q = a->sign;
+    size_t shift = 0, i;
+    big_int_t *w;
+    slot_t inv, q_slot, borrow = 0, tmp;
+    uint64_t prod;
+
+    if (d == 0) return -1;
+    if ((w = big_int_assign(a)) == NULL) return -1;
+    while ((d & 1) == 0) { d >>= 1; shift++; }
+    if (shift != 0)
+    {
+        if (w->bit_length <= shift) __big_int_set_zero(w);
+        else big_int_right_shift(w, (int)shift);
+    }
+    inv = __big_int_slot_inverse(d);
+    for (i = 0; i != w->slot_length; i++)
+    {
+        tmp = w->slot[i];
+        q_slot = (tmp - borrow) * inv;
+        prod = (uint64_t)q_slot * d;
+        /* (tmp - borrow) - low(q * d) is zero, only the high part borrows */
+        borrow = (slot_t)(prod >> BIT_PER_SLOT) + (tmp < borrow);
+        w->slot[i] = q_slot;
+    }
+    __big_int_normalize(w);
+    if (!big_int_is_zero(w)) w->sign = sign_q;
+    __big_int_move_to(q, w);
     return 0;
 }
 
+/* q = a / d, d must divide a exactly, otherwise the result is undefined */
+int big_int_divexact_u64(big_int_t *q, big_int_t *a, uint64_t d)
+{
+    int ret;
+    big_int_t *divisor;
+
+    if ((d >> BIT_PER_SLOT) == 0) return big_int_divexact_u32(q, a, (uint32_t)d);
+    if ((divisor = __big_int_new_zero(MUL_SLOT(2))) == NULL) return -1;
+    divisor->slot[0] = (slot_t)d;
+    divisor->slot[1] = (slot_t)(d >> BIT_PER_SLOT);
+    divisor->slot_length = 2;
+    __big_int_normalize(divisor);
+    ret = big_int_divexact(q, a, divisor);
+    big_int_destroy(divisor);
+    return ret;
+}
+
 /* Barrett Reduction method, a faster algorithm to compute modulo 
  * with pre-computed value
  * Described in http://en.wikipedia.org/wiki/Barrett_reduction */
@@ -1355,50 +1985,29 @@ int big_int_mod_to_with_barret(big_int_t *num1, big_int_t *num2, big_int_t *barr
     return 0;
 }
 
-/* num1 >= num2 */
+/* num1 = num1 % num2, the remainder takes the sign of num1
+ * repeated moduli are reduced with a cached Barrett context */
+#define BIG_NUMBER_MOD_CACHE_THRESHOLD 2
 int big_int_mod_to(big_int_t *num1, big_int_t *num2)
 {
-	int ret;
-    unsigned int slot_idx;
-    int bit_delta;
-	big_int_t *divisor;
+    int ret;
+    big_int_ctx_cache_entry_t *entry;
+    big_int_barrett_ctx_t *barrett;
 
-    ret = big_int_compare(num1, num2);
-    if (ret == 0)
+    if ((num1->sign == BIG_NUMBER_POSITIVE) && (num2->sign == BIG_NUMBER_POSITIVE) && \
+            (num2->slot_length >= BIG_NUMBER_MOD_CACHE_THRESHOLD) && \
+            (num1->slot_length <= (num2->slot_length << 1)) && \
+            (big_int_compare_raw(num1, num2) >= 0))
     {
-        /* X % X = 0 */
-        for (slot_idx = 0; slot_idx < num1->slot_length; slot_idx++)
-            num1->slot[slot_idx] = 0;
-        num1->slot_length = 1;
-        num1->bit_length = 1;
-        return 0;
-    }
-    else if (ret == -1)
-    {
-        return 0;
-    }
-    divisor = big_int_assign(num2);
-    if (divisor == NULL) return -1;
-    bit_delta = num1->bit_length - divisor->bit_length;
-    big_int_left_shift(divisor, bit_delta);
-    while (big_int_compare(num1, divisor) == -1) 
-    {
-        big_int_right_shift(divisor, 1);
-        bit_delta--;
-    }
-    for (;;)
-    {
-        big_int_sub_to(num1, divisor);
-        /* TO BE OPTIMIZE: right shift to less */
-        while (((big_int_compare(divisor, num1)) == 1) && bit_delta > 0) /* do loop while num1 < divisor */
+        if ((entry = big_int_ctx_cache_acquire(num2)) != NULL)
         {
-            big_int_right_shift(divisor, 1);
-            bit_delta--;
+            barrett = big_int_ctx_cache_barrett(entry);
+            ret = (barrett != NULL) ? big_int_barrett_reduce(barrett, num1) : -1;
+            big_int_ctx_cache_release(entry);
+            return ret;
         }
-        if (bit_delta == 0 && big_int_compare(divisor, num1) > 0) break;
     }
-    if (divisor != NULL) big_int_destroy(divisor);
-    return 0;
+    return big_int_divrem(NULL, num1, num1, num2);
 }
 
 int big_int_dec(big_int_t *num)
@@ -1418,11 +2027,7 @@ int big_int_dec(big_int_t *num)
         }
         slot_idx++;
     }
-    if (num->slot[num->slot_length - 1] == 0)
-    {
-        num->slot_length--;
-        if (num->slot_length == 0) num->slot_length++;
-    }
+    __big_int_normalize(num);
     return 0;
 }
 
@@ -1436,11 +2041,12 @@ int big_int_add_to_u16(big_int_t *num, unsigned int value)
     for (slot_idx = 0; slot_idx != (signed int)num->slot_length; slot_idx++)
     {
         tmp = (uint64_t)num->slot[slot_idx] + carry;
-        carry = (uint64_t)num->slot[slot_idx] >> BIT_PER_SLOT;
+        carry = (unsigned int)(tmp >> BIT_PER_SLOT);
         num->slot[slot_idx] = tmp & 0xFFFFFFFF;
     }
     if (carry)
     {
+        if (__big_int_reserve(num, num->slot_length + 1) != 0) return -1;
         num->slot[num->slot_length] = 1;
         num->slot_length++;
         num->bit_length = MUL_SLOT(num->slot_length - 1) + 1;
@@ -1452,11 +2058,83 @@ int big_int_add_to_u16(big_int_t *num, unsigned int value)
     return 0;
 }
 
+/* results of pow_to are limited to what the shifts can address */
+#define BIG_NUMBER_POW_MAX_BITS (0x7FFFFFFF)
+
+/* base ^ n, n >= 1, base odd and > 1, by left-to-right
+ * square-and-multiply, bits is an upper bound of the result size,
+ * the buffers are reserved for it once so the steps below the
+ * Karatsuba threshold run in place */
+static big_int_t *__big_int_pow_odd(big_int_t *base, uint64_t n, uint64_t bits)
+{
+    int bit_idx = 63;
+    size_t i, capacity = BIT_TO_SLOT(bits) + 1, new_length;
+    uint64_t tmp;
+    slot_t carry;
+    big_int_t *result = NULL, *other = NULL, *swap;
+
+    if ((result = big_int_assign(base)) == NULL) return NULL;
+    if ((other = big_int_new_from_int(0)) == NULL) goto fail;
+    if (__big_int_reserve(result, capacity) != 0) goto fail;
+    if (__big_int_reserve(other, capacity) != 0) goto fail;
+
+    while (((n >> bit_idx) & 1) == 0) bit_idx--;
+    while (bit_idx-- != 0)
+    {
+        /* result = result ^ 2 */
+        if (result->bit_length <= BIG_NUMBER_MUL_KARATSUBA_THRESHOLD)
+        {
+            new_length = result->slot_length << 1;
+            __big_int_slots_sqr(other->slot, result->slot, result->slot_length);
+            for (i = new_length; i < other->slot_length; i++) other->slot[i] = 0;
+            other->slot_length = new_length;
+            __big_int_normalize(other);
+            swap = result; result = other; other = swap;
+        }
+        else if (big_int_mul_to(result, result) != 0) goto fail;
+        if (((n >> bit_idx) & 1) == 0) continue;
+        /* result = result * base */
+        if (result->bit_length > BIG_NUMBER_MUL_KARATSUBA_THRESHOLD)
+        {
+            if (big_int_mul_to(result, base) != 0) goto fail;
+        }
+        else if (base->slot_length == 1)
+        {
+            carry = 0;
+            for (i = 0; i != result->slot_length; i++)
+            {
+                tmp = (uint64_t)result->slot[i] * base->slot[0] + carry;
+                result->slot[i] = (slot_t)tmp;
+                carry = (slot_t)(tmp >> BIT_PER_SLOT);
+            }
+            result->slot[result->slot_length++] = carry;
+            __big_int_normalize(result);
+        }
+        else
+        {
+            new_length = result->slot_length + base->slot_length;
+            __big_int_slots_mul(other->slot, result->slot, result->slot_length, base->slot, base->slot_length);
+            for (i = new_length; i < other->slot_length; i++) other->slot[i] = 0;
+            other->slot_length = new_length;
+            __big_int_normalize(other);
+            swap = result; result = other; other = swap;
+        }
+    }
+    big_int_destroy(other);
+    return result;
+fail:
+    if (result != NULL) big_int_destroy(result);
+    if (other != NULL) big_int_destroy(other);
+    return NULL;
+}
+
 int big_int_pow_to(big_int_t *num1, big_int_t *num2)
 {
-    int ret;
+    int ret = -1;
     int sign;
-    big_int_t *count = NULL, *result = NULL, *temp = NULL;
+    size_t zeros;
+    uint64_t n;
+    big_int_t *odd = NULL, *result = NULL;
     /* Sign */
     if (num1->sign == BIG_NUMBER_POSITIVE)
     {
@@ -1479,128 +2157,52 @@ int big_int_pow_to(big_int_t *num1, big_int_t *num2)
     }
     else
     {
-        result = big_int_new_from_int(1);
-        count = big_int_assign(num2);
-        if (result == NULL) {ret = -1; goto fail;}
-        if (count == NULL) {ret = -1; goto fail;}
-        if (num1->slot_length == 1 && num1->slot[0] == 2)
+        /* |num1| >= 2, so the exponent has to be small and not negative */
+        if ((num2->sign == BIG_NUMBER_NEGATIVE) || (num2->slot_length > 2)) goto fail;
+        n = num2->slot[0];
+        if (num2->slot_length == 2) n |= (uint64_t)num2->slot[1] << BIT_PER_SLOT;
+        if (n == 0)
         {
-            while (!(count->slot_length == 1 && count->slot[0] == 0))
-            {
-                if (count->slot[0] != 0)
-                {
-                    big_int_left_shift(result, count->slot[0]);
-                    temp = big_int_new_from_int(count->slot[0]);
-                    big_int_sub_to(count, temp);
-                    big_int_destroy(temp); temp = NULL;
-                    /*count->slot[0] = 0;*/
-                }
-                else
-                {
-                    big_int_left_shift(result, 1);
-                    big_int_dec(count);
-                }
-            }
+            result = big_int_new_from_int(1);
         }
         else
         {
-            while (!(count->slot_length == 1 && count->slot[0] == 0))
+            /* num1 = odd * 2^zeros, the power of two is a single shift */
+            zeros = __big_int_trailing_zeros(num1);
+            if ((zeros != 0) && (n > BIG_NUMBER_POW_MAX_BITS / zeros)) goto fail;
+            if ((odd = big_int_assign(num1)) == NULL) goto fail;
+            odd->sign = BIG_NUMBER_POSITIVE;
+            if (zeros != 0) big_int_right_shift(odd, (int)zeros);
+            if (odd->slot_length == 1 && odd->slot[0] == 1)
+            {
+                result = big_int_new_from_int(1);
+            }
+            else
+            {
+                if (n > BIG_NUMBER_POW_MAX_BITS / odd->bit_length) goto fail;
+                result = __big_int_pow_odd(odd, n, n * odd->bit_length);
+            }
+            if (result == NULL) goto fail;
+            if (zeros != 0)
             {
-                big_int_mul_to(result, num1);
-                big_int_dec(count);
+                if (big_int_left_shift(result, (int)(zeros * n)) != 0) goto fail;
             }
         }
     }
-    __big_int_clean_slots(num1->slot, num1->slot_length);
-    __big_int_mem_pool_free(num1->slot, num1->in_pool);
-    num1->slot = result->slot;
-    num1->allocated_slot_length = result->allocated_slot_length;
-    num1->bit_length = result->bit_length;
-    num1->slot_length = result->slot_length;
-    num1->sign = sign;
-    num1->in_pool = result->in_pool;
-    free(result); result = NULL;
-    /* Sign */
+    if (result == NULL) goto fail;
+    if (!big_int_is_zero(result)) result->sign = sign;
+    __big_int_move_to(num1, result); result = NULL;
     ret = 0;
 fail:
-    if (count != NULL) big_int_destroy(count);
+    if (odd != NULL) big_int_destroy(odd);
     if (result != NULL) big_int_destroy(result);
-    if (temp != NULL) big_int_destroy(temp);
     return ret;
 }
 
+/* num1 = num1 / num2, rounded toward zero */
 int big_int_div_to(big_int_t *num1, big_int_t *num2)
 {
-	int ret;
-    int sign = (num1->sign == num2->sign) ? BIG_NUMBER_POSITIVE : BIG_NUMBER_NEGATIVE;
-    unsigned int slot_idx;
-    int bit_delta;
-    big_int_t *quotient;
-    big_int_t *divisor;
-
-    ret = big_int_compare(num1, num2);
-    /* FIXME: Divide by Zero */
-    if (ret == 0)
-    {
-        /* X / X = 1 */
-        for (slot_idx = 0; slot_idx < num1->slot_length; slot_idx++)
-            num1->slot[slot_idx] = 0;
-        num1->slot[0] = 1;
-        num1->slot_length = 1;
-        num1->bit_length = 1;
-        return 0;
-    }
-    else if (ret == -1)
-    {
-        /* min / max = 0 */
-        for (slot_idx = 0; slot_idx < num1->slot_length; slot_idx++)
-            num1->slot[slot_idx] = 0;
-        num1->slot_length = 1;
-        num1->bit_length = 1;
-        return 0;
-    }
-    quotient = __big_int_new_zero(num1->bit_length);
-    divisor = big_int_assign(num2);
-    if (quotient == NULL || divisor == NULL) goto fail;
-    /* Locate divisor */
-    bit_delta = num1->bit_length - divisor->bit_length;
-    big_int_left_shift(divisor, bit_delta);
-    while (big_int_compare(num1, divisor) == -1) 
-    {
-        big_int_right_shift(divisor, 1);
-        bit_delta--;
-    }
-    quotient->bit_length = bit_delta;
-    quotient->slot_length = BIT_TO_SLOT(bit_delta + 1);
-    /* Divide */
-    for (;;)
-    {
-        quotient->slot[bit_delta / BIT_PER_SLOT] |= 1 << (bit_delta % BIT_PER_SLOT);
-        big_int_sub_to(num1, divisor);
-        /* TO BE OPTIMIZE: right shift to less */
-        while (((big_int_compare(divisor, num1)) == 1) && bit_delta > 0) /* do loop while num1 < divisor */
-        {
-            big_int_right_shift(divisor, 1);
-            bit_delta--;
-        }
-        if (bit_delta == 0 && big_int_compare(divisor, num1) > 0) break;
-    }
-    __big_int_clean_slots(num1->slot, num1->slot_length);
-    __big_int_mem_pool_free(num1->slot, num1->in_pool);
-    num1->slot = quotient->slot;
-    num1->slot_length = quotient->slot_length;
-    num1->bit_length = quotient->bit_length;
-    /* Sign */
-    num1->sign = sign;
-    num1->in_pool = quotient->in_pool;
-    /* Zero check */
-    if (big_int_is_zero(num1)) num1->sign = BIG_NUMBER_POSITIVE;
-    free(quotient); quotient = NULL;
-    ret = 0;
-fail:
-    if (quotient != NULL) big_int_destroy(quotient);
-    if (divisor != NULL) big_int_destroy(divisor);
-    return ret;
+    return big_int_divrem(num1, NULL, num1, num2);
 }
 
 int big_int_pow_mod_to(big_int_t *num1, big_int_t *num2, big_int_t *num3)
@@ -1611,6 +2213,13 @@ int big_int_pow_mod_to(big_int_t *num1, big_int_t *num2, big_int_t *num3)
     int bit_count;
     big_int_t *result = NULL, *temp = NULL;
 
+    /* the common case goes through Montgomery or Barrett contexts */
+    if ((num1->sign == BIG_NUMBER_POSITIVE) && !big_int_is_zero(num1) && \
+            (num2->sign == BIG_NUMBER_POSITIVE) && !big_int_is_zero(num3))
+    {
+        return big_int_powm(num1, num1, num2, num3);
+    }
+
     /* Sign for pow part */
     if (num1->sign == BIG_NUMBER_POSITIVE)
     {
@@ -1682,6 +2291,14 @@ int big_int_pow_mod_to_with_barret(big_int_t *num1, big_int_t *num2, big_int_t *
     int bit_count;
     big_int_t *result = NULL, *temp = NULL;
 
+    /* the common case goes through the sliding window in powm, which
+     * caches its own reduction context */
+    if ((num1->sign == BIG_NUMBER_POSITIVE) && !big_int_is_zero(num1) && \
+            (num2->sign == BIG_NUMBER_POSITIVE) && !big_int_is_zero(num3))
+    {
+        return big_int_powm(num1, num1, num2, num3);
+    }
+
 	/* Sign for pow part */
     if (num1->sign == BIG_NUMBER_POSITIVE)
     {
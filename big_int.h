@@ -65,7 +65,12 @@ big_int_t *big_int_mul(big_int_t *num1, big_int_t *num2);
 int big_int_mul_to(big_int_t *num1, big_int_t *num2);
 int big_int_sub_to(big_int_t *num1, big_int_t *num2); /* num1 >= num2 */
 int big_int_div_to(big_int_t *num1, big_int_t *num2);
-int big_int_mod_to(big_int_t *num1, big_int_t *num2); /* num1 >= num2 */
+int big_int_mod_to(big_int_t *num1, big_int_t *num2);
+int big_int_divrem(big_int_t *q, big_int_t *r, big_int_t *a, big_int_t *b); /* rounded toward zero */
+int big_int_divrem_floor(big_int_t *q, big_int_t *r, big_int_t *a, big_int_t *b); /* rounded toward -inf */
+int big_int_divexact(big_int_t *q, big_int_t *a, big_int_t *b); /* b | a, otherwise undefined */
+int big_int_divexact_u32(big_int_t *q, big_int_t *a, uint32_t d); /* d | a, otherwise undefined */
+int big_int_divexact_u64(big_int_t *q, big_int_t *a, uint64_t d); /* d | a, otherwise undefined */
 int big_int_dec(big_int_t *num);
 int big_int_add_to_u16(big_int_t *num, unsigned int value);
 int big_int_pow_to(big_int_t *num1, big_int_t *num2);
@@ -77,10 +82,25 @@ int big_int_right_shift(big_int_t *num, int bit_length);
 big_int_t *big_int_barret_build(big_int_t *num_divisor);
 int big_int_mod_to_with_barret(big_int_t *num1, big_int_t *num2, big_int_t *barret);
 int big_int_pow_mod_to_with_barret(big_int_t *num1, big_int_t *num2, big_int_t *num3, big_int_t *num3_barret);
-/* memory pool */
+/* memory pool, allocation is locked so ints may be used from several
+ * threads, initialize and uninitialize must not race with them */
 int big_int_mem_pool_initialize(size_t size);
 int big_int_mem_pool_uninitialize(void);
 
+/* internal */
+int __big_int_reserve(big_int_t *num, size_t slot_length);
+void __big_int_normalize(big_int_t *num);
+void __big_int_move_to(big_int_t *dst, big_int_t *src);
+slot_t __big_int_slots_addmul_1(slot_t *r, const slot_t *a, size_t n, slot_t b);
+void __big_int_slots_mul(slot_t *r, const slot_t *a, size_t an, const slot_t *b, size_t bn);
+void __big_int_slots_sqr(slot_t *r, const slot_t *a, size_t n);
+slot_t __big_int_slots_submul_1(slot_t *r, const slot_t *a, size_t n, slot_t b);
+slot_t __big_int_slot_inverse(slot_t d);
+slot_t __big_int_slots_divrem_1(slot_t *q, const slot_t *u, size_t m, slot_t v);
+void __big_int_slots_divrem(slot_t *q, slot_t *r, \
+        const slot_t *u, size_t m, const slot_t *v, size_t n, \
+        slot_t *un, slot_t *vn);
+
 /* debug */
 int __big_int_mul_karatsuba_split(big_int_t *num, unsigned int shift, big_int_t **high, big_int_t **low);
 big_int_t *__big_int_mul_karatsuba(big_int_t *num1, big_int_t *num2);
@@ -0,0 +1,278 @@
+/*
+   Big Integer Library - Barrett Reduction
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+
+#define MIN(a,b) ((a)<(b)?(a):(b))
+#define BIT_PER_SLOT (32)
+#define MUL_SLOT(x) ((uint64_t)(x)<<5)
+
+/* Barrett reduction in whole slots (HAC Algorithm 14.42)
+ * b = 2^32, k = slots of m, mu = b^(2k) / m
+ * q = ((x / b^(k-1)) * mu) / b^(k+1)
+ * r = (x - q * m) mod b^(k+1), then r < 3m for x < b^(2k) */
+
+struct big_int_barrett_ctx
+{
+    big_int_t *modulus;
+    big_int_t *mu;
+    size_t k; /* slots of modulus */
+    /* scratch */
+    slot_t *x; /* 2k slots, the value to reduce */
+    slot_t *q; /* (k + 1) + mu slots, estimated quotient */
+    slot_t *r2; /* k + 1 slots, q * m mod b^(k+1) */
+    slot_t *r; /* k + 1 slots, result */
+};
+
+big_int_barrett_ctx_t *big_int_barrett_ctx_new(big_int_t *modulus)
+{
+    size_t k;
+    big_int_barrett_ctx_t *ctx = NULL;
+
+    if ((modulus->sign == BIG_NUMBER_NEGATIVE) || big_int_is_zero(modulus)) return NULL;
+    ctx = (big_int_barrett_ctx_t *)malloc(sizeof(big_int_barrett_ctx_t));
+    if (ctx == NULL) return NULL;
+    ctx->mu = NULL;
+    ctx->x = ctx->q = ctx->r2 = ctx->r = NULL;
+    if ((ctx->modulus = big_int_assign(modulus)) == NULL) goto fail;
+    k = ctx->k = modulus->slot_length;
+
+    /* mu = b^(2k) / m */
+    if ((ctx->mu = big_int_new_from_int(1)) == NULL) goto fail;
+    if (big_int_left_shift(ctx->mu, (int)MUL_SLOT(k << 1)) != 0) goto fail;
+    if (big_int_div_to(ctx->mu, modulus) != 0) goto fail;
+
+    ctx->x = (slot_t *)malloc(sizeof(slot_t) * (k << 1));
+    ctx->q = (slot_t *)malloc(sizeof(slot_t) * (k + 1 + ctx->mu->slot_length));
+    ctx->r2 = (slot_t *)malloc(sizeof(slot_t) * (k + 1));
+    ctx->r = (slot_t *)malloc(sizeof(slot_t) * (k + 1));
+    if (ctx->x == NULL || ctx->q == NULL || ctx->r2 == NULL || ctx->r == NULL) goto fail;
+    return ctx;
+fail:
+    big_int_barrett_ctx_destroy(ctx);
+    return NULL;
+}
+
+int big_int_barrett_ctx_destroy(big_int_barrett_ctx_t *ctx)
+{
+    if (ctx->modulus != NULL) big_int_destroy(ctx->modulus);
+    if (ctx->mu != NULL) big_int_destroy(ctx->mu);
+    if (ctx->x != NULL) free(ctx->x);
+    if (ctx->q != NULL) free(ctx->q);
+    if (ctx->r2 != NULL) free(ctx->r2);
+    if (ctx->r != NULL) free(ctx->r);
+    free(ctx);
+    return 0;
+}
+
+big_int_t *big_int_barrett_ctx_modulus(big_int_barrett_ctx_t *ctx)
+{
+    return ctx->modulus;
+}
+
+/* compare r (k + 1 slots) with m (k slots) */
+static int __big_int_barrett_compare(const slot_t *r, const slot_t *m, size_t k)
+{
+    size_t i;
+
+    if (r[k] != 0) return 1;
+    for (i = k; i-- != 0;)
+    {
+        if (r[i] != m[i]) return (r[i] > m[i]) ? 1 : -1;
+    }
+    return 0;
+}
+
+/* r[0..n-1] -= b[0..bn-1], returns the borrow */
+static slot_t __big_int_barrett_sub(slot_t *r, const slot_t *b, size_t n, size_t bn)
+{
+    size_t i;
+    slot_t borrow = 0, sub, tmp;
+
+    for (i = 0; i != n; i++)
+    {
+        sub = (i < bn) ? b[i] : 0;
+        tmp = r[i];
+        r[i] = tmp - sub - borrow;
+        borrow = (tmp < sub) || ((tmp == sub) && borrow);
+    }
+    return borrow;
+}
+
+/* ctx->r = ctx->x mod m, the 2k slots of ctx->x are all filled */
+static void __big_int_barrett_reduce_slots(big_int_barrett_ctx_t *ctx)
+{
+    size_t i, k = ctx->k, len;
+    size_t q3_length = ctx->mu->slot_length;
+    slot_t *m = ctx->modulus->slot;
+    slot_t *q3 = ctx->q + k + 1;
+
+    /* q3 = ((x / b^(k-1)) * mu) / b^(k+1) */
+    __big_int_slots_mul(ctx->q, ctx->x + k - 1, k + 1, ctx->mu->slot, q3_length);
+
+    /* r2 = q3 * m mod b^(k+1), the slots above are never needed */
+    for (i = 0; i != k + 1; i++) ctx->r2[i] = 0;
+    for (i = 0; i != MIN(q3_length, k + 1); i++)
+    {
+        len = MIN(k, k + 1 - i);
+        if (i + len < k + 1) ctx->r2[i + len] += __big_int_slots_addmul_1(ctx->r2 + i, m, len, q3[i]);
+        else __big_int_slots_addmul_1(ctx->r2 + i, m, len, q3[i]);
+    }
+
+    /* r = x mod b^(k+1) - r2, a borrow is the wrap around of b^(k+1) */
+    for (i = 0; i != k + 1; i++) ctx->r[i] = ctx->x[i];
+    __big_int_barrett_sub(ctx->r, ctx->r2, k + 1, k + 1);
+
+    /* r < 3m, at most two subtractions */
+    if (__big_int_barrett_compare(ctx->r, m, k) >= 0)
+    {
+        __big_int_barrett_sub(ctx->r, m, k + 1, k);
+        if (__big_int_barrett_compare(ctx->r, m, k) >= 0)
+            __big_int_barrett_sub(ctx->r, m, k + 1, k);
+    }
+}
+
+/* write the k slots result into num */
+static int __big_int_barrett_store(big_int_barrett_ctx_t *ctx, big_int_t *num)
+{
+    size_t i, k = ctx->k;
+
+    if (__big_int_reserve(num, k) != 0) return -1;
+    for (i = 0; i != k; i++) num->slot[i] = ctx->r[i];
+    for (; i < num->slot_length; i++) num->slot[i] = 0;
+    num->slot_length = k;
+    num->sign = BIG_NUMBER_POSITIVE;
+    __big_int_normalize(num);
+    return 0;
+}
+
+/* r = t mod m with long division, for values out of the fast path */
+static int __big_int_barrett_fallback(big_int_barrett_ctx_t *ctx, big_int_t *r, big_int_t *t)
+{
+    if (big_int_divrem_floor(NULL, t, t, ctx->modulus) != 0)
+    {
+        big_int_destroy(t);
+        return -1;
+    }
+    __big_int_move_to(r, t);
+    return 0;
+}
+
+/* num = num mod m */
+int big_int_barrett_reduce(big_int_barrett_ctx_t *ctx, big_int_t *num)
+{
+    size_t i, k = ctx->k;
+
+    if ((num->sign == BIG_NUMBER_NEGATIVE) || (num->slot_length > (k << 1)))
+    {
+        return big_int_divrem_floor(NULL, num, num, ctx->modulus);
+    }
+    for (i = 0; i != num->slot_length; i++) ctx->x[i] = num->slot[i];
+    for (; i != (k << 1); i++) ctx->x[i] = 0;
+    __big_int_barrett_reduce_slots(ctx);
+    return __big_int_barrett_store(ctx, num);
+}
+
+/* r = a * b mod m */
+int big_int_barrett_mulmod(big_int_barrett_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    size_t i, k = ctx->k;
+    big_int_t *t;
+
+    if (a == b) return big_int_barrett_sqrmod(ctx, r, a);
+    if ((a->sign == BIG_NUMBER_NEGATIVE) || (b->sign == BIG_NUMBER_NEGATIVE) || \
+            (a->slot_length > k) || (b->slot_length > k))
+    {
+        if ((t = big_int_mul(a, b)) == NULL) return -1;
+        return __big_int_barrett_fallback(ctx, r, t);
+    }
+    __big_int_slots_mul(ctx->x, a->slot, a->slot_length, b->slot, b->slot_length);
+    for (i = a->slot_length + b->slot_length; i < (k << 1); i++) ctx->x[i] = 0;
+    __big_int_barrett_reduce_slots(ctx);
+    return __big_int_barrett_store(ctx, r);
+}
+
+/* r = a^2 mod m */
+int big_int_barrett_sqrmod(big_int_barrett_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    size_t i, k = ctx->k;
+    big_int_t *t;
+
+    if ((a->sign == BIG_NUMBER_NEGATIVE) || (a->slot_length > k))
+    {
+        if ((t = big_int_mul(a, a)) == NULL) return -1;
+        return __big_int_barrett_fallback(ctx, r, t);
+    }
+    __big_int_slots_sqr(ctx->x, a->slot, a->slot_length);
+    for (i = a->slot_length << 1; i < (k << 1); i++) ctx->x[i] = 0;
+    __big_int_barrett_reduce_slots(ctx);
+    return __big_int_barrett_store(ctx, r);
+}
+
+/* a copy of the context running on the caller's scratch,
+ * the context itself is only read */
+static void __big_int_barrett_borrow(big_int_barrett_ctx_t *local, big_int_barrett_ctx_t *ctx, slot_t *scratch)
+{
+    *local = *ctx;
+    local->x = scratch;
+    local->q = local->x + (ctx->k << 1);
+    local->r2 = local->q + ctx->k + 1 + ctx->mu->slot_length;
+    local->r = local->r2 + ctx->k + 1;
+}
+
+size_t big_int_barrett_scratch_size(big_int_barrett_ctx_t *ctx)
+{
+    return (ctx->k << 1) + (ctx->k + 1 + ctx->mu->slot_length) + ((ctx->k + 1) << 1);
+}
+
+int big_int_barrett_reduce_with(big_int_barrett_ctx_t *ctx, slot_t *scratch, big_int_t *num)
+{
+    big_int_barrett_ctx_t local;
+
+    __big_int_barrett_borrow(&local, ctx, scratch);
+    return big_int_barrett_reduce(&local, num);
+}
+
+int big_int_barrett_mulmod_with(big_int_barrett_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    big_int_barrett_ctx_t local;
+
+    __big_int_barrett_borrow(&local, ctx, scratch);
+    return big_int_barrett_mulmod(&local, r, a, b);
+}
+
+int big_int_barrett_sqrmod_with(big_int_barrett_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a)
+{
+    big_int_barrett_ctx_t local;
+
+    __big_int_barrett_borrow(&local, ctx, scratch);
+    return big_int_barrett_sqrmod(&local, r, a);
+}
@@ -0,0 +1,338 @@
+/*
+   Big Integer Library - Chinese Remainder
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+#include "big_int_gcd.h"
+#include "big_int_crt.h"
+
+/* Garner's algorithm up to this many moduli, a subproduct tree above */
+#define BIG_INT_CRT_GARNER_MAX 4
+
+/* Garner: x_0 = r_0, x_i = x_(i-1) + P_i ((r_i - x_(i-1)) c_i mod m_i)
+ *   with P_i = m_0 .. m_(i-1) and c_i = P_i^-1 mod m_i
+ * tree: x = sum r_i c_i (M / m_i) mod M with c_i = (M / m_i)^-1 mod m_i,
+ *   the sum is formed bottom up, a node takes
+ *   v = v_left prod_right + v_right prod_left */
+
+struct big_int_crt_ctx
+{
+    size_t n;
+    big_int_t *modulus; /* M */
+    big_int_barrett_ctx_t **reducers; /* mod m_i */
+    big_int_t **inverses; /* c_i */
+    /* Garner */
+    big_int_t **partials; /* P_i */
+    /* tree, level 0 are the moduli themselves */
+    big_int_t ***tree;
+    size_t depth;
+};
+
+static size_t __big_int_crt_level_length(size_t n, size_t level)
+{
+    while (level-- != 0) n = (n + 1) >> 1;
+    return n;
+}
+
+static big_int_t *__big_int_crt_node(big_int_crt_ctx_t *ctx, size_t level, size_t idx)
+{
+    if (level == 0) return big_int_barrett_ctx_modulus(ctx->reducers[idx]);
+    return ctx->tree[level][idx];
+}
+
+static void __big_int_crt_level_destroy(big_int_t **level, size_t length)
+{
+    size_t i;
+
+    for (i = 0; i != length; i++)
+    {
+        if (level[i] != NULL) big_int_destroy(level[i]);
+    }
+    free(level);
+}
+
+static big_int_t **__big_int_crt_level_new(size_t length)
+{
+    size_t i;
+    big_int_t **level;
+
+    if ((level = (big_int_t **)malloc(sizeof(big_int_t *) * length)) == NULL) return NULL;
+    for (i = 0; i != length; i++) level[i] = NULL;
+    return level;
+}
+
+static int __big_int_crt_garner_init(big_int_crt_ctx_t *ctx)
+{
+    size_t i;
+    big_int_t *p;
+
+    if ((ctx->partials = __big_int_crt_level_new(ctx->n)) == NULL) return -1;
+    if ((p = big_int_new_from_int(1)) == NULL) return -1;
+    for (i = 1; i != ctx->n; i++)
+    {
+        if (big_int_mul_to(p, __big_int_crt_node(ctx, 0, i - 1)) != 0) goto fail;
+        if ((ctx->partials[i] = big_int_assign(p)) == NULL) goto fail;
+        if ((ctx->inverses[i] = big_int_new_from_int(0)) == NULL) goto fail;
+        if (big_int_invert(ctx->inverses[i], p, __big_int_crt_node(ctx, 0, i)) != 0) goto fail;
+    }
+    if (big_int_mul_to(p, __big_int_crt_node(ctx, 0, ctx->n - 1)) != 0) goto fail;
+    ctx->modulus = p;
+    return 0;
+fail:
+    big_int_destroy(p);
+    return -1;
+}
+
+static int __big_int_crt_tree_init(big_int_crt_ctx_t *ctx)
+{
+    int ret = -1;
+    size_t level, i, length, child_length;
+    big_int_t **cofactors = NULL, **child_cofactors = NULL;
+    big_int_t *c;
+
+    /* products up to the root */
+    for (ctx->depth = 0; __big_int_crt_level_length(ctx->n, ctx->depth) != 1; ctx->depth++);
+    if ((ctx->tree = (big_int_t ***)malloc(sizeof(big_int_t **) * (ctx->depth + 1))) == NULL) return -1;
+    for (level = 0; level <= ctx->depth; level++) ctx->tree[level] = NULL;
+    for (level = 1; level <= ctx->depth; level++)
+    {
+        length = __big_int_crt_level_length(ctx->n, level);
+        child_length = __big_int_crt_level_length(ctx->n, level - 1);
+        if ((ctx->tree[level] = __big_int_crt_level_new(length)) == NULL) return -1;
+        for (i = 0; i != length; i++)
+        {
+            if ((i << 1) + 1 == child_length) ctx->tree[level][i] = big_int_assign(__big_int_crt_node(ctx, level - 1, i << 1));
+            else ctx->tree[level][i] = big_int_mul(__big_int_crt_node(ctx, level - 1, i << 1), __big_int_crt_node(ctx, level - 1, (i << 1) + 1));
+            if (ctx->tree[level][i] == NULL) return -1;
+        }
+    }
+    if ((ctx->modulus = big_int_assign(__big_int_crt_node(ctx, ctx->depth, 0))) == NULL) return -1;
+
+    /* (M / node) mod node down to the leaves,
+     * M / left = (M / node) right */
+    level = ctx->depth;
+    if ((cofactors = __big_int_crt_level_new(1)) == NULL) return -1;
+    if ((cofactors[0] = big_int_new_from_int(1)) == NULL) goto fail;
+    for (; level != 0; level--)
+    {
+        length = __big_int_crt_level_length(ctx->n, level);
+        child_length = __big_int_crt_level_length(ctx->n, level - 1);
+        if ((child_cofactors = __big_int_crt_level_new(child_length)) == NULL) goto fail;
+        for (i = 0; i != child_length; i++)
+        {
+            if ((i ^ 1) == child_length) c = big_int_assign(cofactors[i >> 1]);
+            else c = big_int_mul(cofactors[i >> 1], __big_int_crt_node(ctx, level - 1, i ^ 1));
+            if ((child_cofactors[i] = c) == NULL) goto fail;
+            if (big_int_divrem_floor(NULL, c, c, __big_int_crt_node(ctx, level - 1, i)) != 0) goto fail;
+        }
+        __big_int_crt_level_destroy(cofactors, length);
+        cofactors = child_cofactors;
+        child_cofactors = NULL;
+    }
+    for (i = 0; i != ctx->n; i++)
+    {
+        if ((ctx->inverses[i] = big_int_new_from_int(0)) == NULL) goto fail;
+        if (big_int_invert(ctx->inverses[i], cofactors[i], __big_int_crt_node(ctx, 0, i)) != 0) goto fail;
+    }
+    ret = 0;
+fail:
+    if (cofactors != NULL) __big_int_crt_level_destroy(cofactors, __big_int_crt_level_length(ctx->n, level));
+    if (child_cofactors != NULL) __big_int_crt_level_destroy(child_cofactors, __big_int_crt_level_length(ctx->n, level - 1));
+    return ret;
+}
+
+big_int_crt_ctx_t *big_int_crt_ctx_new(big_int_t **moduli, size_t n)
+{
+    size_t i;
+    big_int_t *m;
+    big_int_crt_ctx_t *ctx;
+
+    if (n == 0) return NULL;
+    if ((ctx = (big_int_crt_ctx_t *)malloc(sizeof(big_int_crt_ctx_t))) == NULL) return NULL;
+    ctx->n = n;
+    ctx->modulus = NULL;
+    ctx->inverses = ctx->partials = NULL;
+    ctx->tree = NULL;
+    ctx->depth = 0;
+    if ((ctx->reducers = (big_int_barrett_ctx_t **)malloc(sizeof(big_int_barrett_ctx_t *) * n)) == NULL) goto fail;
+    for (i = 0; i != n; i++) ctx->reducers[i] = NULL;
+    if ((ctx->inverses = __big_int_crt_level_new(n)) == NULL) goto fail;
+    for (i = 0; i != n; i++)
+    {
+        if ((m = big_int_assign(moduli[i])) == NULL) goto fail;
+        m->sign = BIG_NUMBER_POSITIVE;
+        ctx->reducers[i] = big_int_barrett_ctx_new(m);
+        big_int_destroy(m);
+        if (ctx->reducers[i] == NULL) goto fail;
+    }
+    if (n <= BIG_INT_CRT_GARNER_MAX)
+    {
+        if (__big_int_crt_garner_init(ctx) != 0) goto fail;
+    }
+    else
+    {
+        if (__big_int_crt_tree_init(ctx) != 0) goto fail;
+    }
+    return ctx;
+fail:
+    big_int_crt_ctx_destroy(ctx);
+    return NULL;
+}
+
+int big_int_crt_ctx_destroy(big_int_crt_ctx_t *ctx)
+{
+    size_t i;
+
+    if (ctx->tree != NULL)
+    {
+        for (i = 1; i <= ctx->depth; i++)
+        {
+            if (ctx->tree[i] != NULL) __big_int_crt_level_destroy(ctx->tree[i], __big_int_crt_level_length(ctx->n, i));
+        }
+        free(ctx->tree);
+    }
+    if (ctx->partials != NULL) __big_int_crt_level_destroy(ctx->partials, ctx->n);
+    if (ctx->inverses != NULL) __big_int_crt_level_destroy(ctx->inverses, ctx->n);
+    if (ctx->reducers != NULL)
+    {
+        for (i = 0; i != ctx->n; i++)
+        {
+            if (ctx->reducers[i] != NULL) big_int_barrett_ctx_destroy(ctx->reducers[i]);
+        }
+        free(ctx->reducers);
+    }
+    if (ctx->modulus != NULL) big_int_destroy(ctx->modulus);
+    free(ctx);
+    return 0;
+}
+
+big_int_t *big_int_crt_ctx_modulus(big_int_crt_ctx_t *ctx)
+{
+    return ctx->modulus;
+}
+
+/* r_i mod m_i */
+static big_int_t *__big_int_crt_residue(big_int_crt_ctx_t *ctx, big_int_t *x, size_t i)
+{
+    big_int_t *r;
+
+    if ((r = big_int_assign(x)) == NULL) return NULL;
+    if (big_int_barrett_reduce(ctx->reducers[i], r) != 0)
+    {
+        big_int_destroy(r);
+        return NULL;
+    }
+    return r;
+}
+
+static int __big_int_crt_garner(big_int_crt_ctx_t *ctx, big_int_t *r, big_int_t **residues)
+{
+    int ret = -1;
+    size_t i;
+    big_int_t *x, *t = NULL, *u = NULL;
+
+    if ((x = __big_int_crt_residue(ctx, residues[0], 0)) == NULL) return -1;
+    for (i = 1; i != ctx->n; i++)
+    {
+        /* u = (r_i - x) c_i mod m_i */
+        if ((t = __big_int_crt_residue(ctx, x, i)) == NULL) goto fail;
+        if ((u = __big_int_crt_residue(ctx, residues[i], i)) == NULL) goto fail;
+        if (big_int_sub_to(u, t) != 0) goto fail;
+        if ((u->sign == BIG_NUMBER_NEGATIVE) && (big_int_add_to(u, __big_int_crt_node(ctx, 0, i)) != 0)) goto fail;
+        if (big_int_barrett_mulmod(ctx->reducers[i], u, u, ctx->inverses[i]) != 0) goto fail;
+        if (big_int_mul_to(u, ctx->partials[i]) != 0) goto fail;
+        if (big_int_add_to(x, u) != 0) goto fail;
+        big_int_destroy(t); t = NULL;
+        big_int_destroy(u); u = NULL;
+    }
+    ret = big_int_assign_to(r, x);
+fail:
+    big_int_destroy(x);
+    if (t != NULL) big_int_destroy(t);
+    if (u != NULL) big_int_destroy(u);
+    return ret;
+}
+
+static int __big_int_crt_tree(big_int_crt_ctx_t *ctx, big_int_t *r, big_int_t **residues)
+{
+    int ret = -1;
+    size_t level, i, length = ctx->n, child_length;
+    big_int_t **values, **child_values = NULL;
+    big_int_t *v, *t;
+
+    /* leaves, r_i c_i mod m_i */
+    if ((values = __big_int_crt_level_new(length)) == NULL) return -1;
+    for (i = 0; i != length; i++)
+    {
+        if ((values[i] = __big_int_crt_residue(ctx, residues[i], i)) == NULL) goto fail;
+        if (big_int_barrett_mulmod(ctx->reducers[i], values[i], values[i], ctx->inverses[i]) != 0) goto fail;
+    }
+    for (level = 1; level <= ctx->depth; level++)
+    {
+        child_values = values;
+        child_length = length;
+        length = __big_int_crt_level_length(ctx->n, level);
+        if ((values = __big_int_crt_level_new(length)) == NULL) goto fail;
+        for (i = 0; i != length; i++)
+        {
+            if ((i << 1) + 1 == child_length)
+            {
+                /* carried up alone */
+                values[i] = child_values[i << 1];
+                child_values[i << 1] = NULL;
+                continue;
+            }
+            if ((v = big_int_mul(child_values[i << 1], __big_int_crt_node(ctx, level - 1, (i << 1) + 1))) == NULL) goto fail;
+            values[i] = v;
+            if ((t = big_int_mul(child_values[(i << 1) + 1], __big_int_crt_node(ctx, level - 1, i << 1))) == NULL) goto fail;
+            if (big_int_add_to(v, t) != 0)
+            {
+                big_int_destroy(t);
+                goto fail;
+            }
+            big_int_destroy(t);
+        }
+        __big_int_crt_level_destroy(child_values, child_length);
+        child_values = NULL;
+    }
+    /* the sum is below n M, the quotient is short */
+    if (big_int_divrem_floor(NULL, values[0], values[0], ctx->modulus) != 0) goto fail;
+    ret = big_int_assign_to(r, values[0]);
+fail:
+    if (child_values != NULL) __big_int_crt_level_destroy(child_values, child_length);
+    if (values != NULL) __big_int_crt_level_destroy(values, length);
+    return ret;
+}
+
+int big_int_crt(big_int_crt_ctx_t *ctx, big_int_t *r, big_int_t **residues)
+{
+    if (ctx->tree == NULL) return __big_int_crt_garner(ctx, r, residues);
+    return __big_int_crt_tree(ctx, r, residues);
+}
@@ -0,0 +1,50 @@
+/*
+   Big Integer Library - Chinese Remainder
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_CRT_H_
+#define _BIG_INT_CRT_H_
+
+#include "big_int.h"
+
+/* Chinese remainder context for a fixed set of pairwise coprime moduli,
+ * the inverses and partial products are computed once.
+ * Few moduli are recombined with Garner's algorithm, many with a
+ * subproduct tree. */
+typedef struct big_int_crt_ctx big_int_crt_ctx_t;
+
+/* moduli != 0, their signs are ignored,
+ * NULL if the moduli are not pairwise coprime */
+big_int_crt_ctx_t *big_int_crt_ctx_new(big_int_t **moduli, size_t n);
+int big_int_crt_ctx_destroy(big_int_crt_ctx_t *ctx);
+big_int_t *big_int_crt_ctx_modulus(big_int_crt_ctx_t *ctx); /* product of the moduli */
+
+/* r in [0, M) with r = residues[i] mod moduli[i],
+ * residues of any sign and size are accepted */
+int big_int_crt(big_int_crt_ctx_t *ctx, big_int_t *r, big_int_t **residues);
+
+#endif
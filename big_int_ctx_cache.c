@@ -0,0 +1,200 @@
+/*
+   Big Integer Library - Reduction Context Cache
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+#include <pthread.h>
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+#include "big_int_montgomery.h"
+#include "big_int_special.h"
+#include "big_int_ctx_cache.h"
+
+#define BIG_INT_CTX_CACHE_SIZE 16
+#define BIG_INT_CTX_CACHE_SEEN_SIZE (BIG_INT_CTX_CACHE_SIZE * 2)
+
+struct big_int_ctx_cache_entry
+{
+    uint64_t fingerprint;
+    big_int_t *modulus; /* NULL for unused entry */
+    big_int_mont_ctx_t *mont;
+    big_int_barrett_ctx_t *barrett;
+    big_int_special_ctx_t *special;
+    int special_checked; /* the modulus has been tested for a special form */
+    int busy;
+    uint64_t last_use;
+};
+
+static pthread_mutex_t cache_lock = PTHREAD_MUTEX_INITIALIZER;
+static big_int_ctx_cache_entry_t cache_entries[BIG_INT_CTX_CACHE_SIZE];
+/* fingerprints seen once, waiting for admission */
+static uint64_t cache_seen[BIG_INT_CTX_CACHE_SEEN_SIZE];
+static size_t cache_seen_next = 0;
+static uint64_t cache_tick = 0;
+
+/* FNV-1a over the slots */
+static uint64_t __big_int_ctx_cache_fingerprint(big_int_t *num)
+{
+    size_t slot_idx;
+    int byte_idx;
+    uint64_t hash = 14695981039346656037ULL;
+
+    for (slot_idx = 0; slot_idx != num->slot_length; slot_idx++)
+    {
+        for (byte_idx = 0; byte_idx != 4; byte_idx++)
+        {
+            hash ^= (num->slot[slot_idx] >> (byte_idx << 3)) & 0xFF;
+            hash *= 1099511628211ULL;
+        }
+    }
+    /* zero is never a fingerprint, it marks the empty seen slots */
+    return (hash == 0) ? 1 : hash;
+}
+
+static void __big_int_ctx_cache_entry_free(big_int_ctx_cache_entry_t *entry)
+{
+    if (entry->modulus != NULL) big_int_destroy(entry->modulus);
+    if (entry->mont != NULL) big_int_mont_ctx_destroy(entry->mont);
+    if (entry->barrett != NULL) big_int_barrett_ctx_destroy(entry->barrett);
+    if (entry->special != NULL) big_int_special_ctx_destroy(entry->special);
+    entry->modulus = NULL;
+    entry->mont = NULL;
+    entry->barrett = NULL;
+    entry->special = NULL;
+    entry->special_checked = 0;
+    entry->busy = 0;
+}
+
+/* returns 1 when the fingerprint was seen before, otherwise remember it */
+static int __big_int_ctx_cache_seen(uint64_t fingerprint)
+{
+    size_t idx;
+
+    for (idx = 0; idx != BIG_INT_CTX_CACHE_SEEN_SIZE; idx++)
+    {
+        if (cache_seen[idx] == fingerprint)
+        {
+            cache_seen[idx] = 0;
+            return 1;
+        }
+    }
+    cache_seen[cache_seen_next] = fingerprint;
+    cache_seen_next = (cache_seen_next + 1) % BIG_INT_CTX_CACHE_SEEN_SIZE;
+    return 0;
+}
+
+big_int_ctx_cache_entry_t *big_int_ctx_cache_acquire(big_int_t *modulus)
+{
+    size_t idx;
+    uint64_t fingerprint = __big_int_ctx_cache_fingerprint(modulus);
+    big_int_ctx_cache_entry_t *entry = NULL, *victim = NULL;
+
+    pthread_mutex_lock(&cache_lock);
+    for (idx = 0; idx != BIG_INT_CTX_CACHE_SIZE; idx++)
+    {
+        if ((cache_entries[idx].modulus != NULL) && \
+                (cache_entries[idx].fingerprint == fingerprint) && \
+                (big_int_compare(cache_entries[idx].modulus, modulus) == 0))
+        {
+            entry = &cache_entries[idx];
+            break;
+        }
+    }
+    if (entry != NULL)
+    {
+        /* hit, unless someone else is using it */
+        if (entry->busy) entry = NULL;
+        else entry->busy = 1;
+        goto done;
+    }
+
+    if (__big_int_ctx_cache_seen(fingerprint) == 0) goto done;
+
+    /* admit, into an empty entry or the least recently used idle one */
+    for (idx = 0; idx != BIG_INT_CTX_CACHE_SIZE; idx++)
+    {
+        if (cache_entries[idx].busy) continue;
+        if (cache_entries[idx].modulus == NULL) { victim = &cache_entries[idx]; break; }
+        if ((victim == NULL) || (cache_entries[idx].last_use < victim->last_use)) victim = &cache_entries[idx];
+    }
+    if (victim == NULL) goto done;
+    __big_int_ctx_cache_entry_free(victim);
+    if ((victim->modulus = big_int_assign(modulus)) == NULL) goto done;
+    victim->fingerprint = fingerprint;
+    victim->busy = 1;
+    entry = victim;
+done:
+    if (entry != NULL) entry->last_use = ++cache_tick;
+    pthread_mutex_unlock(&cache_lock);
+    return entry;
+}
+
+void big_int_ctx_cache_release(big_int_ctx_cache_entry_t *entry)
+{
+    pthread_mutex_lock(&cache_lock);
+    entry->busy = 0;
+    pthread_mutex_unlock(&cache_lock);
+}
+
+/* the entry is held exclusively, no lock needed for building */
+big_int_mont_ctx_t *big_int_ctx_cache_mont(big_int_ctx_cache_entry_t *entry)
+{
+    if (entry->mont == NULL) entry->mont = big_int_mont_ctx_new(entry->modulus);
+    return entry->mont;
+}
+
+big_int_barrett_ctx_t *big_int_ctx_cache_barrett(big_int_ctx_cache_entry_t *entry)
+{
+    if (entry->barrett == NULL) entry->barrett = big_int_barrett_ctx_new(entry->modulus);
+    return entry->barrett;
+}
+
+big_int_special_ctx_t *big_int_ctx_cache_special(big_int_ctx_cache_entry_t *entry)
+{
+    if (!entry->special_checked)
+    {
+        entry->special = big_int_special_ctx_new(entry->modulus);
+        entry->special_checked = 1;
+    }
+    return entry->special;
+}
+
+int big_int_ctx_cache_clear(void)
+{
+    size_t idx;
+
+    pthread_mutex_lock(&cache_lock);
+    for (idx = 0; idx != BIG_INT_CTX_CACHE_SIZE; idx++)
+    {
+        if (!cache_entries[idx].busy) __big_int_ctx_cache_entry_free(&cache_entries[idx]);
+    }
+    for (idx = 0; idx != BIG_INT_CTX_CACHE_SEEN_SIZE; idx++) cache_seen[idx] = 0;
+    pthread_mutex_unlock(&cache_lock);
+    return 0;
+}
+
@@ -0,0 +1,55 @@
+/*
+   Big Integer Library - Reduction Context Cache
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_CTX_CACHE_H_
+#define _BIG_INT_CTX_CACHE_H_
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+#include "big_int_montgomery.h"
+#include "big_int_special.h"
+
+/* Bounded cache of reduction contexts keyed by modulus,
+ * a modulus is admitted on its second sighting, the least recently
+ * used idle entry is evicted when full.
+ * An acquired entry is held exclusively until released, NULL is
+ * returned when the modulus is not admitted yet or the entry is
+ * busy, callers then build a private context. */
+typedef struct big_int_ctx_cache_entry big_int_ctx_cache_entry_t;
+
+big_int_ctx_cache_entry_t *big_int_ctx_cache_acquire(big_int_t *modulus); /* modulus > 0 */
+void big_int_ctx_cache_release(big_int_ctx_cache_entry_t *entry);
+/* contexts of an acquired entry, built on first use */
+big_int_mont_ctx_t *big_int_ctx_cache_mont(big_int_ctx_cache_entry_t *entry);
+big_int_barrett_ctx_t *big_int_ctx_cache_barrett(big_int_ctx_cache_entry_t *entry);
+big_int_special_ctx_t *big_int_ctx_cache_special(big_int_ctx_cache_entry_t *entry); /* NULL if not special */
+/* drop all idle entries */
+int big_int_ctx_cache_clear(void);
+
+#endif 
+
@@ -0,0 +1,239 @@
+/*
+   Big Integer Library - Factorial and Binomial Coefficients
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_factorial.h"
+#include "big_int_product.h"
+
+/* Factorials from prime factorizations
+ *
+ * The exponent of a prime p in n! is the sum of n / p^i (Legendre),
+ * binomial and multinomial coefficients take the differences, so a
+ * sieve gives them without a single division of big numbers.
+ * The prime powers are packed into slot sized words for the product
+ * tree.
+ * n! itself uses the prime swing (Luschny), n! = (n/2)!^2 * swing(n)
+ * where p appears in swing(n) sum((n / p^i) & 1) times, the factors
+ * of two go in as a single shift at the end. */
+
+typedef struct
+{
+    uint32_t *words;
+    size_t count, capacity;
+    uint64_t acc;
+} big_int_fac_factors_t;
+
+static int __big_int_fac_factors_flush(big_int_fac_factors_t *factors)
+{
+    uint32_t *words;
+
+    if (factors->acc == 1) return 0;
+    if (factors->count == factors->capacity)
+    {
+        factors->capacity = (factors->capacity == 0) ? 64 : factors->capacity * 2;
+        words = (uint32_t *)realloc(factors->words, sizeof(uint32_t) * factors->capacity);
+        if (words == NULL) return -1;
+        factors->words = words;
+    }
+    factors->words[factors->count++] = (uint32_t)factors->acc;
+    factors->acc = 1;
+    return 0;
+}
+
+/* factors *= p^e */
+static int __big_int_fac_factors_push(big_int_fac_factors_t *factors, uint32_t p, size_t e)
+{
+    while (e-- != 0)
+    {
+        if (factors->acc * p > 0xFFFFFFFF)
+        {
+            if (__big_int_fac_factors_flush(factors) != 0) return -1;
+        }
+        factors->acc *= p;
+    }
+    return 0;
+}
+
+/* composite[i] for odd i <= n */
+static char *__big_int_fac_sieve(unsigned int n)
+{
+    size_t i, j;
+    char *composite;
+
+    if ((composite = (char *)calloc((size_t)n + 1, 1)) == NULL) return NULL;
+    for (i = 3; i * i <= n; i += 2)
+    {
+        if (composite[i]) continue;
+        for (j = i * i; j <= n; j += 2 * i) composite[j] = 1;
+    }
+    return composite;
+}
+
+/* sum of n / p^i */
+static size_t __big_int_fac_legendre(unsigned int n, uint32_t p)
+{
+    size_t e = 0;
+
+    while (n >= p) { n /= p; e += n; }
+    return e;
+}
+
+/* product of the odd prime factors of n! / k[0]! / ... / k[count - 1]!,
+ * the power of two goes to twos */
+static big_int_t *__big_int_fac_quotient(unsigned int n, const unsigned int *k, size_t count, size_t *twos)
+{
+    size_t i, e;
+    uint32_t p;
+    char *composite = NULL;
+    big_int_t *result = NULL;
+    big_int_fac_factors_t factors = { NULL, 0, 0, 1 };
+
+    if ((composite = __big_int_fac_sieve(n)) == NULL) return NULL;
+    *twos = __big_int_fac_legendre(n, 2);
+    for (i = 0; i != count; i++) *twos -= __big_int_fac_legendre(k[i], 2);
+    for (p = 3; p <= n; p += 2)
+    {
+        if (composite[p]) continue;
+        e = __big_int_fac_legendre(n, p);
+        for (i = 0; i != count; i++) e -= __big_int_fac_legendre(k[i], p);
+        if (__big_int_fac_factors_push(&factors, p, e) != 0) goto fail;
+        if (p > 0xFFFFFFFF - 2) break;
+    }
+    if (__big_int_fac_factors_flush(&factors) != 0) goto fail;
+    result = __big_int_prod_words(factors.words, factors.count, NULL);
+fail:
+    free(composite);
+    if (factors.words != NULL) free(factors.words);
+    return result;
+}
+
+/* odd part of n!, (n/2)! squared times the swing */
+static big_int_t *__big_int_fac_odd(unsigned int n, const char *composite, big_int_fac_factors_t *factors)
+{
+    size_t e;
+    uint32_t p, q;
+    big_int_t *result, *swing;
+
+    if (n < 3) return big_int_new_from_int(1);
+    if ((result = __big_int_fac_odd(n / 2, composite, factors)) == NULL) return NULL;
+    factors->count = 0;
+    for (p = 3; p <= n; p += 2)
+    {
+        if (composite[p]) continue;
+        for (e = 0, q = n / p; q != 0; q /= p) e += q & 1;
+        if (__big_int_fac_factors_push(factors, p, e) != 0) goto fail;
+        if (p > 0xFFFFFFFF - 2) break;
+    }
+    if (__big_int_fac_factors_flush(factors) != 0) goto fail;
+    if ((swing = __big_int_prod_words(factors->words, factors->count, NULL)) == NULL) goto fail;
+    if (big_int_mul_to(result, result) != 0) { big_int_destroy(swing); goto fail; }
+    if (big_int_mul_to(result, swing) != 0) { big_int_destroy(swing); goto fail; }
+    big_int_destroy(swing);
+    return result;
+fail:
+    big_int_destroy(result);
+    return NULL;
+}
+
+int big_int_fac(big_int_t *r, unsigned int n)
+{
+    int ret = -1;
+    unsigned int ones, rest;
+    char *composite = NULL;
+    big_int_t *result = NULL;
+    big_int_fac_factors_t factors = { NULL, 0, 0, 1 };
+
+    if ((composite = __big_int_fac_sieve(n)) == NULL) return -1;
+    if ((result = __big_int_fac_odd(n, composite, &factors)) == NULL) goto fail;
+    /* n! has n - popcount(n) factors of two */
+    for (ones = 0, rest = n; rest != 0; rest &= rest - 1) ones++;
+    if (big_int_left_shift(result, (int)(n - ones)) != 0) goto fail;
+    __big_int_move_to(r, result); result = NULL;
+    ret = 0;
+fail:
+    free(composite);
+    if (factors.words != NULL) free(factors.words);
+    if (result != NULL) big_int_destroy(result);
+    return ret;
+}
+
+int big_int_multinomial(big_int_t *r, const unsigned int *k, size_t count)
+{
+    size_t i, twos;
+    unsigned int n = 0;
+    big_int_t *result;
+
+    for (i = 0; i != count; i++)
+    {
+        if (k[i] > 0xFFFFFFFF - n) return -1;
+        n += k[i];
+    }
+    if ((result = __big_int_fac_quotient(n, k, count, &twos)) == NULL) return -1;
+    if (big_int_left_shift(result, (int)twos) != 0) { big_int_destroy(result); return -1; }
+    __big_int_move_to(r, result);
+    return 0;
+}
+
+int big_int_binomial(big_int_t *r, unsigned int n, unsigned int k)
+{
+    int ret = -1;
+    unsigned int i, parts[2];
+    uint32_t *words = NULL;
+    big_int_t *result = NULL, *divisor = NULL;
+
+    if (k > n)
+    {
+        if ((result = big_int_new_from_int(0)) == NULL) return -1;
+        __big_int_move_to(r, result);
+        return 0;
+    }
+    if (k > n - k) k = n - k;
+    if ((uint64_t)k * k > n)
+    {
+        parts[0] = k;
+        parts[1] = n - k;
+        return big_int_multinomial(r, parts, 2);
+    }
+    /* few factors on a long range, n (n - 1) ... (n - k + 1) / k!
+     * costs less than sieving up to n */
+    if ((words = (uint32_t *)malloc(sizeof(uint32_t) * (k + 1))) == NULL) return -1;
+    for (i = 0; i != k; i++) words[i] = n - i;
+    if ((result = __big_int_prod_words(words, k, NULL)) == NULL) goto fail;
+    if ((divisor = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_fac(divisor, k) != 0) goto fail;
+    if (big_int_divexact(result, result, divisor) != 0) goto fail;
+    __big_int_move_to(r, result); result = NULL;
+    ret = 0;
+fail:
+    free(words);
+    if (result != NULL) big_int_destroy(result);
+    if (divisor != NULL) big_int_destroy(divisor);
+    return ret;
+}
@@ -0,0 +1,1080 @@
+/*
+   Big Integer Library - Greatest Common Divisor
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_powm.h"
+#include "big_int_gcd.h"
+
+#define BIT_PER_SLOT (32)
+#define MAX(a,b) ((a)>(b)?(a):(b))
+#define MIN(a,b) ((a)<(b)?(a):(b))
+
+/* cofactors of a Lehmer step have to fit in one slot */
+#define BIG_INT_GCD_COFACTOR_MAX ((int64_t)0xFFFFFFFF)
+/* bits of the leading part driving a Lehmer step, two slots less
+ * the headroom for the signed cofactor sums */
+#define BIG_INT_GCD_LEHMER_BITS 62
+/* half-gcd above this many bits of the smaller operand */
+#define BIG_INT_GCD_HGCD_THRESHOLD 262144
+/* half-gcd calls below this size reduce by single steps */
+#define BIG_INT_GCD_HGCD_BASE 16384
+
+/* binary gcd of two words */
+static uint64_t __big_int_gcd_u64(uint64_t u, uint64_t v)
+{
+    int shift = 0;
+    uint64_t t;
+
+    if (u == 0) return v;
+    if (v == 0) return u;
+    while (((u | v) & 1) == 0) { u >>= 1; v >>= 1; shift++; }
+    while ((u & 1) == 0) u >>= 1;
+    do
+    {
+        while ((v & 1) == 0) v >>= 1;
+        if (u > v) { t = u; u = v; v = t; }
+        v -= u;
+    } while (v != 0);
+    return u << shift;
+}
+
+static size_t __big_int_gcd_length(const slot_t *a, size_t n)
+{
+    while ((n > 1) && (a[n - 1] == 0)) n--;
+    return n;
+}
+
+static size_t __big_int_gcd_bit_length(const slot_t *a, size_t n)
+{
+    size_t bits = (n - 1) * BIT_PER_SLOT;
+    slot_t top = a[n - 1];
+
+    while (top != 0) { top >>= 1; bits++; }
+    return bits;
+}
+
+static uint64_t __big_int_gcd_u64_of(const slot_t *a, size_t n)
+{
+    return (n > 1) ? (((uint64_t)a[1] << BIT_PER_SLOT) | a[0]) : a[0];
+}
+
+/* bits [shift, shift + 62) of a[0..n-1] */
+static int64_t __big_int_gcd_top(const slot_t *a, size_t n, size_t shift)
+{
+    size_t idx = shift / BIT_PER_SLOT, bit = shift % BIT_PER_SLOT;
+    uint64_t value = 0;
+
+    if (idx < n) value = a[idx] >> bit;
+    if (idx + 1 < n) value |= (uint64_t)a[idx + 1] << (BIT_PER_SLOT - bit);
+    if ((bit != 0) && (idx + 2 < n)) value |= (uint64_t)a[idx + 2] << (2 * BIT_PER_SLOT - bit);
+    return (int64_t)(value & (((uint64_t)1 << BIG_INT_GCD_LEHMER_BITS) - 1));
+}
+
+/* Lehmer's inner loop, Algorithm L in <<The Art of Computer
+ * Programming>> Volume 2, Chapter 4.5.2, run on the leading 62 bits,
+ * the cofactors are kept within one slot,
+ * returns 0 when no quotient could be decided (B == 0) */
+static int __big_int_gcd_lehmer(int64_t x, int64_t y, int64_t *cofactor)
+{
+    int64_t a = 1, b = 0, c = 0, d = 1, q, t;
+
+    for (;;)
+    {
+        /* the true quotient lies between the two */
+        if ((y + c <= 0) || (y + d <= 0)) break;
+        q = (x + a) / (y + c);
+        if ((q == 0) || (q != (x + b) / (y + d))) break;
+        /* |a - qc| = |a| + q|c| as the signs alternate */
+        if ((c != 0) && (q > (BIG_INT_GCD_COFACTOR_MAX - (a < 0 ? -a : a)) / (c < 0 ? -c : c))) break;
+        if ((d != 0) && (q > (BIG_INT_GCD_COFACTOR_MAX - (b < 0 ? -b : b)) / (d < 0 ? -d : d))) break;
+        t = a - q * c; a = c; c = t;
+        t = b - q * d; b = d; d = t;
+        t = x - q * y; x = y; y = t;
+    }
+    cofactor[0] = a; cofactor[1] = b;
+    cofactor[2] = c; cofactor[3] = d;
+    return b != 0;
+}
+
+/* r[0..n] = x * a + y * b >= 0 with x, y of opposite signs */
+static void __big_int_gcd_combine(slot_t *r, const slot_t *a, const slot_t *b, size_t n, int64_t x, int64_t y)
+{
+    size_t i;
+    slot_t borrow;
+
+    for (i = 0; i != n; i++) r[i] = 0;
+    if (y <= 0)
+    {
+        r[n] = __big_int_slots_addmul_1(r, a, n, (slot_t)x);
+        borrow = __big_int_slots_submul_1(r, b, n, (slot_t)(-y));
+    }
+    else
+    {
+        r[n] = __big_int_slots_addmul_1(r, b, n, (slot_t)y);
+        borrow = __big_int_slots_submul_1(r, a, n, (slot_t)(-x));
+    }
+    r[n] -= borrow;
+}
+
+/* compare |a| with |b| */
+static int __big_int_gcd_abs_cmp(big_int_t *a, big_int_t *b)
+{
+    size_t idx;
+
+    if (a->slot_length != b->slot_length) return (a->slot_length < b->slot_length) ? -1 : 1;
+    for (idx = a->slot_length; idx-- != 0;)
+    {
+        if (a->slot[idx] != b->slot[idx]) return (a->slot[idx] < b->slot[idx]) ? -1 : 1;
+    }
+    return 0;
+}
+
+/* r = the value of a[0..n-1] */
+static int __big_int_gcd_store(big_int_t *r, const slot_t *a, size_t n)
+{
+    size_t i;
+
+    if (__big_int_reserve(r, n) != 0) return -1;
+    for (i = 0; i != n; i++) r->slot[i] = a[i];
+    for (; i < r->slot_length; i++) r->slot[i] = 0;
+    r->slot_length = n;
+    r->sign = BIG_NUMBER_POSITIVE;
+    __big_int_normalize(r);
+    return 0;
+}
+
+/* r = gcd(|a|, |b|) by Lehmer steps */
+static int __big_int_gcd_lehmer_big(big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    int ret;
+    size_t i, n, na, nb, shift;
+    slot_t word[2];
+    uint64_t g;
+    int64_t cofactor[4];
+    slot_t *buffer, *u, *v, *s, *t, *q, *un, *vn, *swap;
+
+    if (__big_int_gcd_abs_cmp(a, b) < 0) return __big_int_gcd_lehmer_big(r, b, a);
+    if (big_int_is_zero(b)) return __big_int_gcd_store(r, a->slot, a->slot_length);
+
+    /* |a| >= |b| > 0 */
+    n = a->slot_length + 1;
+    if ((buffer = (slot_t *)malloc(sizeof(slot_t) * 7 * n)) == NULL) return -1;
+    for (i = 0; i != 7 * n; i++) buffer[i] = 0;
+    u = buffer; v = u + n; s = v + n; t = s + n;
+    q = t + n; un = q + n; vn = un + n;
+    for (i = 0; i != a->slot_length; i++) u[i] = a->slot[i];
+    for (i = 0; i != b->slot_length; i++) v[i] = b->slot[i];
+    na = a->slot_length;
+    nb = b->slot_length;
+
+    /* Lehmer steps while the operands are longer than two slots,
+     * a step that decides no quotient is a full division */
+    while ((na > 2) && !((nb == 1) && (v[0] == 0)))
+    {
+        if (nb == 1)
+        {
+            s[0] = __big_int_slots_divrem_1(q, u, na, v[0]);
+            swap = u; u = v; v = s; s = swap;
+            na = nb = 1;
+            break;
+        }
+        shift = __big_int_gcd_bit_length(u, na);
+        shift = (shift > BIG_INT_GCD_LEHMER_BITS) ? shift - BIG_INT_GCD_LEHMER_BITS : 0;
+        if (__big_int_gcd_lehmer(__big_int_gcd_top(u, na, shift), __big_int_gcd_top(v, nb, shift), cofactor))
+        {
+            /* (u, v) = (A u + B v, C u + D v), v is zero above nb */
+            __big_int_gcd_combine(s, u, v, na, cofactor[0], cofactor[1]);
+            __big_int_gcd_combine(t, u, v, na, cofactor[2], cofactor[3]);
+            swap = u; u = s; s = swap;
+            swap = v; v = t; t = swap;
+            na = __big_int_gcd_length(u, na + 1);
+            nb = __big_int_gcd_length(v, na + 1);
+        }
+        else
+        {
+            /* (u, v) = (v, u mod v) */
+            __big_int_slots_divrem(q, s, u, na, v, nb, un, vn);
+            swap = u; u = v; v = s; s = swap;
+            na = nb;
+            nb = __big_int_gcd_length(v, nb);
+        }
+    }
+
+    if ((nb == 1) && (v[0] == 0))
+    {
+        ret = __big_int_gcd_store(r, u, na);
+    }
+    else
+    {
+        /* both fit in a word, binary gcd for the rest */
+        g = __big_int_gcd_u64(__big_int_gcd_u64_of(u, na), __big_int_gcd_u64_of(v, nb));
+        word[0] = (slot_t)g;
+        word[1] = (slot_t)(g >> BIT_PER_SLOT);
+        ret = __big_int_gcd_store(r, word, 2);
+    }
+    free(buffer);
+    return ret;
+}
+
+/* Half-gcd in the formulation of N. Möller, "On Schönhage's algorithm
+ * and subquadratic integer gcd computation", Math. Comp. 77 (2008).
+ * For a, b > 0 of n bits and s = n / 2 + 1 it finds M with
+ * det M = 1 and non-negative entries, such that (a, b) = M (a', b')
+ * with a', b' > 2^s and |a' - b'| <= 2^s.  The upper half is reduced
+ * recursively twice, the matrices are applied to the full numbers
+ * with the general multiplication, below BIG_INT_GCD_HGCD_BASE bits
+ * the quotients come from Lehmer runs and single steps. */
+
+/* x > 2^s for x >= 0 */
+static int __big_int_hgcd_above(big_int_t *x, size_t s)
+{
+    size_t idx;
+
+    if (x->bit_length != s + 1) return x->bit_length > s + 1;
+    for (idx = 0; idx != s / BIT_PER_SLOT; idx++)
+    {
+        if (x->slot[idx] != 0) return 1;
+    }
+    return x->slot[idx] != ((slot_t)1 << (s % BIT_PER_SLOT));
+}
+
+static int __big_int_hgcd_matrix_new(big_int_t **m)
+{
+    int i;
+
+    for (i = 0; i != 4; i++)
+    {
+        if ((m[i] = big_int_new_from_int((i == 0) || (i == 3))) == NULL)
+        {
+            while (i-- != 0) big_int_destroy(m[i]);
+            return -1;
+        }
+    }
+    return 0;
+}
+
+static void __big_int_hgcd_matrix_destroy(big_int_t **m)
+{
+    int i;
+
+    for (i = 0; i != 4; i++) big_int_destroy(m[i]);
+}
+
+static int __big_int_hgcd_matrix_is_identity(big_int_t **m)
+{
+    return big_int_is_zero(m[1]) && big_int_is_zero(m[2]);
+}
+
+/* x += q * y */
+static int __big_int_hgcd_addmul(big_int_t *x, big_int_t *q, big_int_t *y)
+{
+    int ret;
+    big_int_t *t;
+
+    if (big_int_is_zero(y)) return 0;
+    if ((t = big_int_mul(q, y)) == NULL) return -1;
+    ret = big_int_add_to(x, t);
+    big_int_destroy(t);
+    return ret;
+}
+
+/* m = m * n */
+static int __big_int_hgcd_matrix_mul(big_int_t **m, big_int_t **n)
+{
+    int i, ret = -1;
+    big_int_t *r[4] = {NULL, NULL, NULL, NULL};
+
+    for (i = 0; i != 4; i++)
+    {
+        /* r[i][j] = m[i][0] n[0][j] + m[i][1] n[1][j] */
+        if ((r[i] = big_int_mul(m[i & 2], n[i & 1])) == NULL) goto fail;
+        if (__big_int_hgcd_addmul(r[i], m[(i & 2) + 1], n[(i & 1) + 2]) != 0) goto fail;
+    }
+    for (i = 0; i != 4; i++)
+    {
+        __big_int_move_to(m[i], r[i]);
+        r[i] = NULL;
+    }
+    ret = 0;
+fail:
+    for (i = 0; i != 4; i++)
+    {
+        if (r[i] != NULL) big_int_destroy(r[i]);
+    }
+    return ret;
+}
+
+/* (a, b) = M^-1 (a, b) = (m11 a - m01 b, m00 b - m10 a),
+ * left alone and 1 returned when that is not positive */
+static int __big_int_hgcd_matrix_apply(big_int_t **m, big_int_t *a, big_int_t *b)
+{
+    int ret = -1;
+    big_int_t *a1 = NULL, *a2 = NULL, *b1 = NULL, *b2 = NULL;
+
+    if (((a1 = big_int_mul(m[3], a)) == NULL) || ((a2 = big_int_mul(m[1], b)) == NULL)) goto fail;
+    if (((b1 = big_int_mul(m[0], b)) == NULL) || ((b2 = big_int_mul(m[2], a)) == NULL)) goto fail;
+    if ((big_int_compare(a1, a2) <= 0) || (big_int_compare(b1, b2) <= 0))
+    {
+        ret = 1;
+        goto fail;
+    }
+    if ((big_int_sub_to(a1, a2) != 0) || (big_int_sub_to(b1, b2) != 0)) goto fail;
+    __big_int_move_to(a, a1); a1 = NULL;
+    __big_int_move_to(b, b1); b1 = NULL;
+    ret = 0;
+fail:
+    if (a1 != NULL) big_int_destroy(a1);
+    if (a2 != NULL) big_int_destroy(a2);
+    if (b1 != NULL) big_int_destroy(b1);
+    if (b2 != NULL) big_int_destroy(b2);
+    return ret;
+}
+
+/* one step keeping both above 2^s: the larger one x drops by q times
+ * the smaller one y, q = (x - 2^s - 1) / y,
+ * returns 0 when (a, b) is already reduced */
+static int __big_int_hgcd_step(big_int_t *a, big_int_t *b, size_t s, big_int_t *bound, big_int_t **m)
+{
+    int ret = -1;
+    int a_larger = (big_int_compare(a, b) >= 0);
+    big_int_t *x = a_larger ? a : b, *y = a_larger ? b : a;
+    big_int_t *t = NULL, *q = NULL;
+
+    if ((t = big_int_assign(x)) == NULL) return -1;
+    if (big_int_sub_to(t, y) != 0) goto fail;
+    if (!__big_int_hgcd_above(t, s)) { ret = 0; goto fail; }
+    /* t = x - 2^s - 1 >= y */
+    if (big_int_assign_to(t, x) != 0) goto fail;
+    if (big_int_sub_to(t, bound) != 0) goto fail;
+    if ((q = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_divrem(q, NULL, t, y) != 0) goto fail;
+    big_int_destroy(t);
+    if ((t = big_int_mul(q, y)) == NULL) goto fail;
+    if (big_int_sub_to(x, t) != 0) goto fail;
+    /* M = M (1 q; 0 1) or M (1 0; q 1) */
+    if (m == NULL) ;
+    else if (a_larger)
+    {
+        if (__big_int_hgcd_addmul(m[1], q, m[0]) != 0) goto fail;
+        if (__big_int_hgcd_addmul(m[3], q, m[2]) != 0) goto fail;
+    }
+    else
+    {
+        if (__big_int_hgcd_addmul(m[0], q, m[1]) != 0) goto fail;
+        if (__big_int_hgcd_addmul(m[2], q, m[3]) != 0) goto fail;
+    }
+    ret = 1;
+fail:
+    if (t != NULL) big_int_destroy(t);
+    if (q != NULL) big_int_destroy(q);
+    return ret;
+}
+
+static void __big_int_hgcd_swap(big_int_t *x, big_int_t *y)
+{
+    big_int_t t = *x;
+
+    *x = *y;
+    *y = t;
+}
+
+/* r = x * tx + y * ty */
+static int __big_int_hgcd_lincomb(big_int_t *r, big_int_t *x, slot_t tx, big_int_t *y, slot_t ty)
+{
+    size_t i, n = MAX(x->slot_length, y->slot_length) + 2;
+    slot_t carry;
+
+    if (__big_int_reserve(r, n) != 0) return -1;
+    for (i = 0; i != n; i++) r->slot[i] = 0;
+    r->slot[x->slot_length] = __big_int_slots_addmul_1(r->slot, x->slot, x->slot_length, tx);
+    carry = __big_int_slots_addmul_1(r->slot, y->slot, y->slot_length, ty);
+    for (i = y->slot_length; carry != 0; i++)
+    {
+        r->slot[i] += carry;
+        carry = (r->slot[i] < carry);
+    }
+    r->slot_length = n;
+    r->sign = BIG_NUMBER_POSITIVE;
+    __big_int_normalize(r);
+    return 0;
+}
+
+/* a run of quotients found by Lehmer's inner loop on the leading bits,
+ * taken only when both results stay above 2^s so that every quotient
+ * of the run is one the single steps would have taken as well,
+ * returns 0 when it does not apply */
+static int __big_int_hgcd_lehmer_step(big_int_t *a, big_int_t *b, size_t s, big_int_t **m, big_int_t **tmp)
+{
+    int a_larger = (big_int_compare(a, b) >= 0), i;
+    size_t n, shift;
+    int64_t det, cofactor[4];
+    slot_t t[4];
+    big_int_t *x = a_larger ? a : b, *y = a_larger ? b : a;
+
+    if (y->bit_length < s + BIG_INT_GCD_LEHMER_BITS) return 0;
+    shift = x->bit_length - BIG_INT_GCD_LEHMER_BITS;
+    if (!__big_int_gcd_lehmer(__big_int_gcd_top(x->slot, x->slot_length, shift), \
+                __big_int_gcd_top(y->slot, y->slot_length, shift), cofactor)) return 0;
+
+    /* (x', y') = L (x, y), y is read as n slots */
+    n = x->slot_length;
+    if (__big_int_reserve(y, n) != 0) return -1;
+    for (i = 0; i != 2; i++)
+    {
+        if (__big_int_reserve(tmp[i], n + 1) != 0) return -1;
+        __big_int_gcd_combine(tmp[i]->slot, x->slot, y->slot, n, cofactor[2 * i], cofactor[2 * i + 1]);
+        tmp[i]->slot_length = n + 1;
+        tmp[i]->sign = BIG_NUMBER_POSITIVE;
+        __big_int_normalize(tmp[i]);
+    }
+    if (!__big_int_hgcd_above(tmp[0], s) || !__big_int_hgcd_above(tmp[1], s)) return 0;
+
+    /* (x, y) = L^-1 (x', y'), L^-1 = det L (d -b; -c a) has no negative
+     * entries, the results go back to (a, b) swapped when that keeps
+     * the determinant of M at 1 */
+    det = cofactor[0] * cofactor[3] - cofactor[1] * cofactor[2];
+    t[0] = (slot_t)(det * cofactor[3]); t[1] = (slot_t)(-det * cofactor[1]);
+    t[2] = (slot_t)(-det * cofactor[2]); t[3] = (slot_t)(det * cofactor[0]);
+    if (!a_larger)
+    {
+        /* (a, b) = E (x, y) with E the swap */
+        slot_t u = t[0], v = t[1];
+        t[0] = t[2]; t[1] = t[3]; t[2] = u; t[3] = v;
+    }
+    if ((det < 0) != !a_larger)
+    {
+        /* (x', y') = P (a', b') with P the swap */
+        slot_t u = t[0];
+        t[0] = t[1]; t[1] = u;
+        u = t[2]; t[2] = t[3]; t[3] = u;
+        __big_int_hgcd_swap(tmp[0], tmp[1]);
+    }
+    __big_int_hgcd_swap(a, tmp[0]);
+    __big_int_hgcd_swap(b, tmp[1]);
+
+    /* M = M T */
+    if (m != NULL)
+    {
+        for (i = 0; i != 4; i += 2)
+        {
+            if (__big_int_hgcd_lincomb(tmp[0], m[i], t[0], m[i + 1], t[2]) != 0) return -1;
+            if (__big_int_hgcd_lincomb(tmp[1], m[i], t[1], m[i + 1], t[3]) != 0) return -1;
+            __big_int_hgcd_swap(m[i], tmp[0]);
+            __big_int_hgcd_swap(m[i + 1], tmp[1]);
+        }
+    }
+    return 1;
+}
+
+/* steps until (a, b) is reduced, returns 0, or until neither is
+ * longer than stop bits, returns 1 */
+static int __big_int_hgcd_steps(big_int_t *a, big_int_t *b, size_t s, big_int_t **m, size_t stop)
+{
+    int ret = -1, step;
+    big_int_t *bound = NULL, *tmp[2] = {NULL, NULL};
+
+    /* 2^s + 1 */
+    if ((bound = big_int_new_from_int(1)) == NULL) return -1;
+    if (big_int_left_shift(bound, (int)s) != 0) goto fail;
+    if (big_int_add_to_u16(bound, 1) != 0) goto fail;
+    if (((tmp[0] = big_int_new_from_int(0)) == NULL) || ((tmp[1] = big_int_new_from_int(0)) == NULL)) goto fail;
+
+    while (MAX(a->bit_length, b->bit_length) > stop)
+    {
+        if ((step = __big_int_hgcd_lehmer_step(a, b, s, m, tmp)) < 0) goto fail;
+        if (step != 0) continue;
+        if ((step = __big_int_hgcd_step(a, b, s, bound, m)) < 0) goto fail;
+        if (step == 0) { ret = 0; goto fail; }
+    }
+    ret = 1;
+fail:
+    big_int_destroy(bound);
+    if (tmp[0] != NULL) big_int_destroy(tmp[0]);
+    if (tmp[1] != NULL) big_int_destroy(tmp[1]);
+    return ret;
+}
+
+/* reduce the top of (a, b) from bit p on and apply it, m = m * M,
+ * m is NULL when only the reduced numbers are wanted */
+static int __big_int_hgcd_top(big_int_t *a, big_int_t *b, size_t p, big_int_t **m);
+
+static int __big_int_hgcd(big_int_t *a, big_int_t *b, big_int_t **m)
+{
+    int ret;
+    size_t n = MAX(a->bit_length, b->bit_length), s = n / 2 + 1;
+
+    if (!__big_int_hgcd_above(a, s) || !__big_int_hgcd_above(b, s)) return 0;
+
+    if (n > BIG_INT_GCD_HGCD_BASE)
+    {
+        /* the top half brings (a, b) to about 3n/4 bits */
+        if (__big_int_hgcd_top(a, b, n / 2, m) != 0) return -1;
+        if ((ret = __big_int_hgcd_steps(a, b, s, m, s + n / 4)) <= 0) return ret;
+        /* the top of what is left brings it to about n/2 bits */
+        n = MAX(a->bit_length, b->bit_length);
+        if ((n > s + 1) && (__big_int_hgcd_top(a, b, 2 * s - n + 1, m) != 0)) return -1;
+    }
+    return (__big_int_hgcd_steps(a, b, s, m, 0) < 0) ? -1 : 0;
+}
+
+static int __big_int_hgcd_top(big_int_t *a, big_int_t *b, size_t p, big_int_t **m)
+{
+    int ret = -1, applied;
+    big_int_t *a_top = NULL, *b_top = NULL;
+    big_int_t *sub[4];
+
+    if (__big_int_hgcd_matrix_new(sub) != 0) return -1;
+    if (((a_top = big_int_assign(a)) == NULL) || ((b_top = big_int_assign(b)) == NULL)) goto fail;
+    big_int_right_shift(a_top, (int)p);
+    big_int_right_shift(b_top, (int)p);
+    if (big_int_is_zero(a_top) || big_int_is_zero(b_top)) { ret = 0; goto fail; }
+    if (__big_int_hgcd(a_top, b_top, sub) != 0) goto fail;
+    if (!__big_int_hgcd_matrix_is_identity(sub))
+    {
+        /* a matrix that does not fit the full numbers is dropped,
+         * the single steps take over */
+        if ((applied = __big_int_hgcd_matrix_apply(sub, a, b)) < 0) goto fail;
+        if ((applied == 0) && (m != NULL))
+        {
+            if (__big_int_hgcd_matrix_mul(m, sub) != 0) goto fail;
+        }
+    }
+    ret = 0;
+fail:
+    __big_int_hgcd_matrix_destroy(sub);
+    if (a_top != NULL) big_int_destroy(a_top);
+    if (b_top != NULL) big_int_destroy(b_top);
+    return ret;
+}
+
+/* (a, b) = (b, a mod b) with the larger one first */
+static int __big_int_gcd_division_step(big_int_t *a, big_int_t *b)
+{
+    big_int_t *r;
+
+    if (big_int_compare(a, b) < 0) return __big_int_gcd_division_step(b, a);
+    if ((r = big_int_new_from_int(0)) == NULL) return -1;
+    if (big_int_divrem(NULL, r, a, b) != 0) { big_int_destroy(r); return -1; }
+    __big_int_move_to(a, r);
+    return 0;
+}
+
+int big_int_gcd(big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    int ret = -1;
+    big_int_t *x = NULL, *y = NULL;
+
+    if (MIN(a->bit_length, b->bit_length) <= BIG_INT_GCD_HGCD_THRESHOLD) return __big_int_gcd_lehmer_big(r, a, b);
+
+    /* half-gcd reductions with a division step in between */
+    if (((x = big_int_assign(a)) == NULL) || ((y = big_int_assign(b)) == NULL)) goto fail;
+    x->sign = y->sign = BIG_NUMBER_POSITIVE;
+    while (!big_int_is_zero(x) && !big_int_is_zero(y) && \
+            (MIN(x->bit_length, y->bit_length) > BIG_INT_GCD_HGCD_THRESHOLD))
+    {
+        if (__big_int_hgcd(x, y, NULL) != 0) goto fail;
+        if (__big_int_gcd_division_step(x, y) != 0) goto fail;
+    }
+    ret = __big_int_gcd_lehmer_big(r, x, y);
+fail:
+    if (x != NULL) big_int_destroy(x);
+    if (y != NULL) big_int_destroy(y);
+    return ret;
+}
+
+/* Extended gcd on u >= 0, v >= 0 with the cofactors of the first
+ * operand kept as magnitudes: u = su x and v = -sv x modulo the second
+ * operand up to a common sign, which is negative when *negative is
+ * set.  Along the remainder sequence the signs alternate, so every
+ * update of su and sv is a sum of magnitudes.  The loop ends with
+ * v = 0 and u the gcd. */
+static int __big_int_gcdext_reduce(big_int_t *u, big_int_t *v, big_int_t *su, big_int_t *sv, int *negative)
+{
+    int ret = -1, i;
+    size_t n, shift;
+    int64_t cofactor[4];
+    big_int_t *tmp[4] = {NULL, NULL, NULL, NULL}, *q = NULL;
+    big_int_t *m[4];
+
+    for (i = 0; i != 4; i++)
+    {
+        if ((tmp[i] = big_int_new_from_int(0)) == NULL) goto fail;
+    }
+    if ((q = big_int_new_from_int(0)) == NULL) goto fail;
+
+    while (!big_int_is_zero(v))
+    {
+        if (big_int_compare(u, v) < 0)
+        {
+            __big_int_hgcd_swap(u, v);
+            __big_int_hgcd_swap(su, sv);
+            *negative = !*negative;
+            continue;
+        }
+
+        if (v->bit_length > BIG_INT_GCD_HGCD_THRESHOLD)
+        {
+            /* (u, v) = M (u', v'), (su', sv') = (m11 su + m01 sv, m10 su + m00 sv) */
+            if (__big_int_hgcd_matrix_new(m) != 0) goto fail;
+            if ((__big_int_hgcd(u, v, m) != 0) || \
+                    (big_int_assign_to(tmp[0], su) != 0) || (big_int_assign_to(tmp[1], sv) != 0) || \
+                    (big_int_mul_to(su, m[3]) != 0) || (big_int_mul_to(tmp[1], m[1]) != 0) || \
+                    (big_int_add_to(su, tmp[1]) != 0) || \
+                    (big_int_mul_to(sv, m[0]) != 0) || (big_int_mul_to(tmp[0], m[2]) != 0) || \
+                    (big_int_add_to(sv, tmp[0]) != 0))
+            {
+                __big_int_hgcd_matrix_destroy(m);
+                goto fail;
+            }
+            __big_int_hgcd_matrix_destroy(m);
+            if (big_int_compare(u, v) < 0) continue;
+        }
+        else
+        {
+            shift = (u->bit_length > BIG_INT_GCD_LEHMER_BITS) ? u->bit_length - BIG_INT_GCD_LEHMER_BITS : 0;
+            if (__big_int_gcd_lehmer(__big_int_gcd_top(u->slot, u->slot_length, shift), \
+                        __big_int_gcd_top(v->slot, v->slot_length, shift), cofactor))
+            {
+                /* (u, v) = (A u + B v, C u + D v), v is read as n slots */
+                n = u->slot_length;
+                if (__big_int_reserve(v, n) != 0) goto fail;
+                for (i = 0; i != 2; i++)
+                {
+                    if (__big_int_reserve(tmp[i], n + 1) != 0) goto fail;
+                    __big_int_gcd_combine(tmp[i]->slot, u->slot, v->slot, n, cofactor[2 * i], cofactor[2 * i + 1]);
+                    tmp[i]->slot_length = n + 1;
+                    __big_int_normalize(tmp[i]);
+                }
+                if ((__big_int_hgcd_lincomb(tmp[2], su, (slot_t)llabs(cofactor[0]), sv, (slot_t)llabs(cofactor[1])) != 0) || \
+                        (__big_int_hgcd_lincomb(tmp[3], su, (slot_t)llabs(cofactor[2]), sv, (slot_t)llabs(cofactor[3])) != 0)) goto fail;
+                __big_int_hgcd_swap(u, tmp[0]);
+                __big_int_hgcd_swap(v, tmp[1]);
+                __big_int_hgcd_swap(su, tmp[2]);
+                __big_int_hgcd_swap(sv, tmp[3]);
+                /* the sign of u moves to v when A <= 0 < B */
+                if (cofactor[1] > 0) *negative = !*negative;
+                continue;
+            }
+        }
+
+        /* (u, v) = (v, u - q v), (su, sv) = (sv, su + q sv) */
+        if (big_int_divrem(q, tmp[0], u, v) != 0) goto fail;
+        if ((big_int_assign_to(tmp[1], sv) != 0) || (big_int_mul_to(tmp[1], q) != 0) || \
+                (big_int_add_to(tmp[1], su) != 0)) goto fail;
+        __big_int_hgcd_swap(u, v);
+        __big_int_hgcd_swap(v, tmp[0]);
+        __big_int_hgcd_swap(su, sv);
+        __big_int_hgcd_swap(sv, tmp[1]);
+        *negative = !*negative;
+    }
+    ret = 0;
+fail:
+    for (i = 0; i != 4; i++)
+    {
+        if (tmp[i] != NULL) big_int_destroy(tmp[i]);
+    }
+    if (q != NULL) big_int_destroy(q);
+    return ret;
+}
+
+int big_int_gcdext(big_int_t *g, big_int_t *s, big_int_t *t, big_int_t *a, big_int_t *b)
+{
+    int ret = -1, negative = 0;
+    big_int_t *u = NULL, *v = NULL, *su = NULL, *sv = NULL, *rest = NULL;
+
+    if (((u = big_int_assign(a)) == NULL) || ((v = big_int_assign(b)) == NULL)) goto fail;
+    u->sign = v->sign = BIG_NUMBER_POSITIVE;
+    if (((su = big_int_new_from_int(big_int_is_zero(a) ? 0 : 1)) == NULL) || \
+            ((sv = big_int_new_from_int(0)) == NULL)) goto fail;
+    if (__big_int_gcdext_reduce(u, v, su, sv, &negative) != 0) goto fail;
+
+    /* s = +-su for |a|, then for a */
+    if (!big_int_is_zero(su) && ((negative != 0) != (a->sign == BIG_NUMBER_NEGATIVE))) su->sign = BIG_NUMBER_NEGATIVE;
+    if (!big_int_is_zero(b))
+    {
+        /* the half-gcd steps stop short of some quotients, bring s to
+         * the absolutely least residue modulo |b| / g so the bounds hold */
+        if (big_int_divexact(v, b, u) != 0) goto fail;
+        v->sign = BIG_NUMBER_POSITIVE;
+        if (big_int_divrem_floor(NULL, su, su, v) != 0) goto fail;
+        if ((rest = big_int_assign(su)) == NULL) goto fail;
+        if (big_int_left_shift(rest, 1) != 0) goto fail;
+        /* on a tie the s with s a > 0 keeps t the smaller */
+        if (big_int_compare(rest, v) + (a->sign == BIG_NUMBER_NEGATIVE) > 0)
+        {
+            if (big_int_sub_to(su, v) != 0) goto fail;
+        }
+        big_int_destroy(rest); rest = NULL;
+    }
+    if (t != NULL)
+    {
+        /* t = (g - s a) / b */
+        if (big_int_is_zero(b))
+        {
+            if ((rest = big_int_new_from_int(0)) == NULL) goto fail;
+        }
+        else
+        {
+            if ((rest = big_int_mul(su, a)) == NULL) goto fail;
+            if (big_int_sub_to(rest, u) != 0) goto fail;
+            if (big_int_divexact(rest, rest, b) != 0) goto fail;
+            if (!big_int_is_zero(rest)) rest->sign = !rest->sign;
+        }
+        __big_int_move_to(t, rest); rest = NULL;
+    }
+    if (s != NULL) { __big_int_move_to(s, su); su = NULL; }
+    if (g != NULL) { __big_int_move_to(g, u); u = NULL; }
+    ret = 0;
+fail:
+    if (u != NULL) big_int_destroy(u);
+    if (v != NULL) big_int_destroy(v);
+    if (su != NULL) big_int_destroy(su);
+    if (sv != NULL) big_int_destroy(sv);
+    if (rest != NULL) big_int_destroy(rest);
+    return ret;
+}
+
+int big_int_invert(big_int_t *r, big_int_t *a, big_int_t *m)
+{
+    int ret = -1, negative = 0;
+    big_int_t *u = NULL, *v = NULL, *su = NULL, *sv = NULL;
+
+    if (big_int_is_zero(m)) return -1;
+    if ((v = big_int_assign(m)) == NULL) goto fail;
+    v->sign = BIG_NUMBER_POSITIVE;
+    if ((u = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_divrem_floor(NULL, u, a, v) != 0) goto fail;
+    if (((su = big_int_new_from_int(1)) == NULL) || ((sv = big_int_new_from_int(0)) == NULL)) goto fail;
+    if ((v->slot_length == 1) && (v->slot[0] == 1))
+    {
+        /* everything is the inverse of everything modulo 1 */
+        __big_int_move_to(r, u); u = NULL;
+        ret = 0;
+        goto fail;
+    }
+    if (__big_int_gcdext_reduce(u, v, su, sv, &negative) != 0) goto fail;
+    if ((u->slot_length != 1) || (u->slot[0] != 1)) goto fail;
+
+    /* r = su or |m| - su, the cofactor is below |m| */
+    if (negative && !big_int_is_zero(su))
+    {
+        if (big_int_assign_to(v, m) != 0) goto fail;
+        v->sign = BIG_NUMBER_POSITIVE;
+        if (big_int_sub_to(v, su) != 0) goto fail;
+        __big_int_move_to(r, v); v = NULL;
+    }
+    else
+    {
+        __big_int_move_to(r, su); su = NULL;
+    }
+    ret = 0;
+fail:
+    if (u != NULL) big_int_destroy(u);
+    if (v != NULL) big_int_destroy(v);
+    if (su != NULL) big_int_destroy(su);
+    if (sv != NULL) big_int_destroy(sv);
+    return ret;
+}
+
+/* x reduced into [0, m), in place of tmp when it is out of range */
+static big_int_t *__big_int_gcd_residue(big_int_t *x, big_int_t *m, big_int_t *tmp)
+{
+    if ((x->sign == BIG_NUMBER_POSITIVE) && (big_int_compare(x, m) < 0)) return x;
+    if (big_int_divrem_floor(NULL, tmp, x, m) != 0) return NULL;
+    return tmp;
+}
+
+/* Products of the batch inversion go through the exponentiation's
+ * reduction context of the modulus (big_int_powm.h).
+ * A Montgomery product carries a factor 1 / R, which the prefix chain
+ * cancels: with p_i the chained product of x_0 .. x_i and I_i the
+ * chained product of p_i ^ -1 and x_(i+1) .. x_(n-1), I_i p_(i-1) is
+ * x_i ^ -1 exactly, so nothing enters or leaves the Montgomery domain */
+int big_int_invert_batch(big_int_t **out, big_int_t **in, size_t n, big_int_t *mod)
+{
+    int ret = -1;
+    size_t i;
+    big_int_powm_ctx_t ctx;
+    big_int_t *m = NULL, *inv = NULL, *tmp = NULL, *x;
+
+    if (big_int_is_zero(mod)) return -1;
+    if (n == 0) return 0;
+    if ((m = big_int_assign(mod)) == NULL) return -1;
+    m->sign = BIG_NUMBER_POSITIVE;
+    if (((inv = big_int_new_from_int(0)) == NULL) || ((tmp = big_int_new_from_int(0)) == NULL)) goto fail;
+    if ((m->slot_length == 1) && (m->slot[0] == 1))
+    {
+        /* everything is the inverse of everything modulo 1 */
+        for (i = 0; i != n; i++)
+        {
+            if (big_int_assign_to(out[i], inv) != 0) goto fail;
+        }
+        ret = 0;
+        goto fail;
+    }
+    if (__big_int_powm_ctx_init(&ctx, m) != 0) goto fail;
+
+    /* out[i] = p_i */
+    if ((x = __big_int_gcd_residue(in[0], m, tmp)) == NULL) goto uninit;
+    if (big_int_assign_to(out[0], x) != 0) goto uninit;
+    for (i = 1; i != n; i++)
+    {
+        if ((x = __big_int_gcd_residue(in[i], m, tmp)) == NULL) goto uninit;
+        if (__big_int_powm_mul(&ctx, out[i], out[i - 1], x) != 0) goto uninit;
+    }
+
+    /* one inversion, then out[i] = I_i p_(i-1) and I_(i-1) = I_i x_i */
+    if (big_int_invert(inv, out[n - 1], m) != 0) goto uninit;
+    for (i = n - 1; i != 0; i--)
+    {
+        if ((x = __big_int_gcd_residue(in[i], m, tmp)) == NULL) goto uninit;
+        if (__big_int_powm_mul(&ctx, out[i], inv, out[i - 1]) != 0) goto uninit;
+        if (__big_int_powm_mul(&ctx, inv, inv, x) != 0) goto uninit;
+    }
+    if (big_int_assign_to(out[0], inv) != 0) goto uninit;
+    ret = 0;
+uninit:
+    __big_int_powm_ctx_uninit(&ctx);
+fail:
+    if (m != NULL) big_int_destroy(m);
+    if (inv != NULL) big_int_destroy(inv);
+    if (tmp != NULL) big_int_destroy(tmp);
+    return ret;
+}
+
+/* Jacobi symbol along the Euclidean remainders (u, v) -> (v, w),
+ * w = u - q v, after N. Möller's observation that no power of two
+ * has to be removed.  With S(u, v) = (u|v) for odd v and (v|u) for
+ * even v, (a|n) = s S(u, v) holds throughout, and the change of s at
+ * each step only depends on the low bits of u, v and w:
+ *   v odd: (w|v) = (v|w) up to the sign of reciprocity when w is odd
+ *   v = 2^e v' even: (v|u) = (2|u)^e (2|w)^e e(v', u) e(v', w) (v|w)
+ * the symbol is s when the remainders end in 1 and 0 otherwise */
+
+/* u, w: the low 3 bits, v: low 2 bits of v / 2^e, e: twos in v */
+static int __big_int_jacobi_rule(int s, unsigned int u, unsigned int v, unsigned int w, size_t e)
+{
+    if (e == 0)
+    {
+        if (((w & 1) != 0) && ((v & w & 3) == 3)) s = -s;
+        return s;
+    }
+    /* (2|x) = -1 for x = 3, 5 mod 8 */
+    if (((e & 1) != 0) && ((((u & 7) == 3) || ((u & 7) == 5)) != (((w & 7) == 3) || ((w & 7) == 5)))) s = -s;
+    if (((v & 3) == 3) && (((u & 3) == 3) != ((w & 3) == 3))) s = -s;
+    return s;
+}
+
+static size_t __big_int_jacobi_twos(uint64_t x)
+{
+    size_t e = 0;
+
+    while ((x & 1) == 0) { x >>= 1; e++; }
+    return e;
+}
+
+/* one step on words, v != 0 */
+static int __big_int_jacobi_rule_u64(int s, uint64_t u, uint64_t v, uint64_t w)
+{
+    size_t e = __big_int_jacobi_twos(v);
+
+    return __big_int_jacobi_rule(s, (unsigned int)u, (unsigned int)(v >> e), (unsigned int)w, e);
+}
+
+/* one step on slots, v[0..n-1] != 0 */
+static int __big_int_jacobi_rule_slots(int s, const slot_t *u, const slot_t *v, size_t n, const slot_t *w)
+{
+    size_t idx = 0, e;
+
+    while (v[idx] == 0) idx++;
+    e = idx * BIT_PER_SLOT + __big_int_jacobi_twos(v[idx]);
+    return __big_int_jacobi_rule(s, u[0], (unsigned int)__big_int_gcd_top(v, n, e), w[0], e);
+}
+
+/* Lehmer's inner loop as __big_int_gcd_lehmer, the symbol is carried
+ * along with the low words lu, lv of the full remainders, a step is
+ * not taken when the twos of v do not show in them */
+static int __big_int_jacobi_lehmer(int64_t x, int64_t y, int64_t *cofactor, uint64_t lu, uint64_t lv, int *s)
+{
+    int64_t a = 1, b = 0, c = 0, d = 1, q, t;
+    uint64_t lw;
+
+    for (;;)
+    {
+        if ((y + c <= 0) || (y + d <= 0)) break;
+        q = (x + a) / (y + c);
+        if ((q == 0) || (q != (x + b) / (y + d))) break;
+        if ((c != 0) && (q > (BIG_INT_GCD_COFACTOR_MAX - (a < 0 ? -a : a)) / (c < 0 ? -c : c))) break;
+        if ((d != 0) && (q > (BIG_INT_GCD_COFACTOR_MAX - (b < 0 ? -b : b)) / (d < 0 ? -d : d))) break;
+        if ((lv & (((uint64_t)1 << BIG_INT_GCD_LEHMER_BITS) - 1)) == 0) break;
+        lw = lu - (uint64_t)q * lv;
+        *s = __big_int_jacobi_rule_u64(*s, lu, lv, lw);
+        lu = lv; lv = lw;
+        t = a - q * c; a = c; c = t;
+        t = b - q * d; b = d; d = t;
+        t = x - q * y; x = y; y = t;
+    }
+    cofactor[0] = a; cofactor[1] = b;
+    cofactor[2] = c; cofactor[3] = d;
+    return b != 0;
+}
+
+/* (u|v) for 0 <= u < v, v odd */
+static int __big_int_jacobi_lehmer_big(int *r, big_int_t *a, big_int_t *b)
+{
+    int s;
+    size_t i, n, na, nb, shift;
+    uint64_t x, y, z;
+    int64_t cofactor[4];
+    slot_t *buffer, *u, *v, *w, *t, *q, *un, *vn, *swap;
+
+    /* the step from (b, a) to (a, ...) is the first one */
+    s = __big_int_jacobi_rule(1, 0, b->slot[0], a->slot[0], 0);
+    if (b->slot_length <= 2)
+    {
+        x = __big_int_gcd_u64_of(b->slot, b->slot_length);
+        y = __big_int_gcd_u64_of(a->slot, a->slot_length);
+        buffer = NULL;
+        goto words;
+    }
+
+    n = b->slot_length + 1;
+    if ((buffer = (slot_t *)malloc(sizeof(slot_t) * 7 * n)) == NULL) return -1;
+    for (i = 0; i != 7 * n; i++) buffer[i] = 0;
+    u = buffer; v = u + n; w = v + n; t = w + n;
+    q = t + n; un = q + n; vn = un + n;
+    for (i = 0; i != b->slot_length; i++) u[i] = b->slot[i];
+    for (i = 0; i != a->slot_length; i++) v[i] = a->slot[i];
+    na = b->slot_length;
+    nb = a->slot_length;
+
+    while ((na > 2) && !((nb == 1) && (v[0] == 0)))
+    {
+        if (nb == 1)
+        {
+            w[0] = __big_int_slots_divrem_1(q, u, na, v[0]);
+            s = __big_int_jacobi_rule_slots(s, u, v, 1, w);
+            swap = u; u = v; v = w; w = swap;
+            na = nb = 1;
+            break;
+        }
+        shift = __big_int_gcd_bit_length(u, na);
+        shift = (shift > BIG_INT_GCD_LEHMER_BITS) ? shift - BIG_INT_GCD_LEHMER_BITS : 0;
+        if (__big_int_jacobi_lehmer(__big_int_gcd_top(u, na, shift), __big_int_gcd_top(v, nb, shift), cofactor, \
+                    __big_int_gcd_u64_of(u, na), __big_int_gcd_u64_of(v, nb), &s))
+        {
+            __big_int_gcd_combine(w, u, v, na, cofactor[0], cofactor[1]);
+            __big_int_gcd_combine(t, u, v, na, cofactor[2], cofactor[3]);
+            swap = u; u = w; w = swap;
+            swap = v; v = t; t = swap;
+            na = __big_int_gcd_length(u, na + 1);
+            nb = __big_int_gcd_length(v, na + 1);
+        }
+        else
+        {
+            /* (u, v) = (v, u mod v) */
+            for (i = nb; i != n; i++) w[i] = 0;
+            __big_int_slots_divrem(q, w, u, na, v, nb, un, vn);
+            s = __big_int_jacobi_rule_slots(s, u, v, nb, w);
+            swap = u; u = v; v = w; w = swap;
+            na = nb;
+            nb = __big_int_gcd_length(v, nb);
+        }
+    }
+
+    /* words for the rest, a gcd left above two slots is not 1 */
+    if (na > 2) s = 0;
+    x = __big_int_gcd_u64_of(u, na);
+    y = __big_int_gcd_u64_of(v, nb);
+    free(buffer);
+words:
+    while (y != 0)
+    {
+        z = x % y;
+        s = __big_int_jacobi_rule_u64(s, x, y, z);
+        x = y; y = z;
+    }
+    *r = (x == 1) ? s : 0;
+    return 0;
+}
+
+int big_int_jacobi(int *r, big_int_t *a, big_int_t *n)
+{
+    int ret;
+    big_int_t *x;
+
+    if ((n->sign == BIG_NUMBER_NEGATIVE) || ((n->slot[0] & 1) == 0)) return -1;
+    if ((x = big_int_new_from_int(0)) == NULL) return -1;
+    if ((ret = big_int_divrem_floor(NULL, x, a, n)) == 0) ret = __big_int_jacobi_lehmer_big(r, x, n);
+    big_int_destroy(x);
+    return ret;
+}
+
+int big_int_kronecker(int *r, big_int_t *a, big_int_t *n)
+{
+    int ret, s = 1;
+    size_t idx = 0, e;
+    unsigned int a8;
+    big_int_t *m;
+
+    if (big_int_is_zero(n))
+    {
+        /* (a|0) = 1 for a = +-1 */
+        *r = ((a->slot_length == 1) && (a->slot[0] == 1)) ? 1 : 0;
+        return 0;
+    }
+    /* a mod 8 */
+    a8 = a->slot[0] & 7;
+    if (a->sign == BIG_NUMBER_NEGATIVE) a8 = (8 - a8) & 7;
+    if (((n->slot[0] & 1) == 0) && ((a8 & 1) == 0))
+    {
+        *r = 0;
+        return 0;
+    }
+    if ((m = big_int_assign(n)) == NULL) return -1;
+    /* (a|-1) = -1 for a < 0 */
+    if (m->sign == BIG_NUMBER_NEGATIVE)
+    {
+        m->sign = BIG_NUMBER_POSITIVE;
+        if (a->sign == BIG_NUMBER_NEGATIVE) s = -s;
+    }
+    /* (a|2) = -1 for a = 3, 5 mod 8 */
+    while (m->slot[idx] == 0) idx++;
+    e = idx * BIT_PER_SLOT + __big_int_jacobi_twos(m->slot[idx]);
+    if (e != 0)
+    {
+        if (((e & 1) != 0) && ((a8 == 3) || (a8 == 5))) s = -s;
+        if ((ret = big_int_right_shift(m, (int)e)) != 0) goto fail;
+    }
+    if ((ret = big_int_jacobi(r, a, m)) == 0) *r *= s;
+fail:
+    big_int_destroy(m);
+    return ret;
+}
@@ -0,0 +1,56 @@
+/*
+   Big Integer Library - Greatest Common Divisor
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_GCD_H_
+#define _BIG_INT_GCD_H_
+
+#include "big_int.h"
+
+/* r = gcd(|a|, |b|), gcd(0, 0) = 0,
+ * very long operands are reduced by half-gcd first */
+int big_int_gcd(big_int_t *r, big_int_t *a, big_int_t *b);
+
+/* g = gcd(|a|, |b|) = s a + t b with |s| <= |b| / 2g and |t| <= |a| / 2g
+ * unless one operand divides the other, any of g, s, t may be NULL */
+int big_int_gcdext(big_int_t *g, big_int_t *s, big_int_t *t, big_int_t *a, big_int_t *b);
+
+/* r = a ^ -1 mod |m|, 0 <= r < |m|, -1 when gcd(a, m) != 1 */
+int big_int_invert(big_int_t *r, big_int_t *a, big_int_t *m);
+
+/* out[i] = in[i] ^ -1 mod |mod| for i < n by Montgomery's trick, one
+ * inversion and 3(n - 1) products, -1 when any of them has no inverse;
+ * out must not alias in */
+int big_int_invert_batch(big_int_t **out, big_int_t **in, size_t n, big_int_t *mod);
+
+/* r = (a|n) the Jacobi symbol for odd n > 0, -1 returned otherwise,
+ * the reciprocity steps ride on the Lehmer reduction of the gcd */
+int big_int_jacobi(int *r, big_int_t *a, big_int_t *n);
+/* r = (a|n) the Kronecker symbol, any a and n */
+int big_int_kronecker(int *r, big_int_t *a, big_int_t *n);
+
+#endif
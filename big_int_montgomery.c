@@ -0,0 +1,282 @@
+/*
+   Big Integer Library - Montgomery Multiplication
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_montgomery.h"
+
+#define BIT_PER_SLOT (32)
+#define MUL_SLOT(x) ((uint64_t)(x)<<5)
+
+/* Montgomery multiplication
+ * Described in <<Analyzing and Comparing Montgomery Multiplication
+ * Algorithms>> (Koc, Acar, Kaliski), the product is interleaved with
+ * the reduction slot by slot (CIOS), squaring computes the half
+ * product first and reduces afterwards (SOS). */
+
+struct big_int_mont_ctx
+{
+    big_int_t *modulus;
+    size_t k; /* slots of modulus */
+    slot_t n_inv; /* -1 / n mod 2^32 */
+    big_int_t *r2; /* R^2 mod n */
+    /* scratch */
+    slot_t *a; /* k slots, operands padded */
+    slot_t *b; /* k slots */
+    slot_t *t; /* 2k + 2 slots, accumulator */
+};
+
+big_int_mont_ctx_t *big_int_mont_ctx_new(big_int_t *modulus)
+{
+    size_t k;
+    big_int_mont_ctx_t *ctx = NULL;
+
+    if ((modulus->sign == BIG_NUMBER_NEGATIVE) || ((modulus->slot[0] & 1) == 0)) return NULL;
+    ctx = (big_int_mont_ctx_t *)malloc(sizeof(big_int_mont_ctx_t));
+    if (ctx == NULL) return NULL;
+    ctx->r2 = NULL;
+    ctx->a = ctx->b = ctx->t = NULL;
+    if ((ctx->modulus = big_int_assign(modulus)) == NULL) goto fail;
+    k = ctx->k = modulus->slot_length;
+    ctx->n_inv = (slot_t)0 - __big_int_slot_inverse(modulus->slot[0]);
+
+    /* R^2 mod n */
+    if ((ctx->r2 = big_int_new_from_int(1)) == NULL) goto fail;
+    if (big_int_left_shift(ctx->r2, (int)MUL_SLOT(k << 1)) != 0) goto fail;
+    if (big_int_mod_to(ctx->r2, modulus) != 0) goto fail;
+
+    ctx->a = (slot_t *)malloc(sizeof(slot_t) * k);
+    ctx->b = (slot_t *)malloc(sizeof(slot_t) * k);
+    ctx->t = (slot_t *)malloc(sizeof(slot_t) * ((k << 1) + 2));
+    if (ctx->a == NULL || ctx->b == NULL || ctx->t == NULL) goto fail;
+    return ctx;
+fail:
+    big_int_mont_ctx_destroy(ctx);
+    return NULL;
+}
+
+int big_int_mont_ctx_destroy(big_int_mont_ctx_t *ctx)
+{
+    if (ctx->modulus != NULL) big_int_destroy(ctx->modulus);
+    if (ctx->r2 != NULL) big_int_destroy(ctx->r2);
+    if (ctx->a != NULL) free(ctx->a);
+    if (ctx->b != NULL) free(ctx->b);
+    if (ctx->t != NULL) free(ctx->t);
+    free(ctx);
+    return 0;
+}
+
+big_int_t *big_int_mont_ctx_modulus(big_int_mont_ctx_t *ctx)
+{
+    return ctx->modulus;
+}
+
+/* copy a into k padded slots, values out of [0, n) are reduced first */
+static int __big_int_mont_load(big_int_mont_ctx_t *ctx, slot_t *dst, big_int_t *a)
+{
+    size_t i;
+    big_int_t *t = NULL;
+
+    if ((a->sign == BIG_NUMBER_NEGATIVE) || (big_int_compare(a, ctx->modulus) >= 0))
+    {
+        if ((t = big_int_assign(a)) == NULL) return -1;
+        if (big_int_divrem_floor(NULL, t, t, ctx->modulus) != 0)
+        {
+            big_int_destroy(t);
+            return -1;
+        }
+        a = t;
+    }
+    for (i = 0; i != a->slot_length; i++) dst[i] = a->slot[i];
+    for (; i != ctx->k; i++) dst[i] = 0;
+    if (t != NULL) big_int_destroy(t);
+    return 0;
+}
+
+/* the k + 1 slots result t < 2n, leave it in [0, n) and write into num */
+static int __big_int_mont_store(big_int_mont_ctx_t *ctx, big_int_t *num, slot_t *t)
+{
+    size_t i, k = ctx->k;
+    slot_t *n = ctx->modulus->slot;
+    slot_t borrow, tmp;
+    int cmp = (t[k] != 0) ? 1 : 0;
+
+    for (i = k; (cmp == 0) && (i-- != 0);)
+    {
+        if (t[i] != n[i]) cmp = (t[i] > n[i]) ? 1 : -1;
+    }
+    if (cmp >= 0)
+    {
+        borrow = 0;
+        for (i = 0; i != k; i++)
+        {
+            tmp = t[i];
+            t[i] = tmp - n[i] - borrow;
+            borrow = (tmp < n[i]) || ((tmp == n[i]) && borrow);
+        }
+    }
+    if (__big_int_reserve(num, k) != 0) return -1;
+    for (i = 0; i != k; i++) num->slot[i] = t[i];
+    for (; i < num->slot_length; i++) num->slot[i] = 0;
+    num->slot_length = k;
+    num->sign = BIG_NUMBER_POSITIVE;
+    __big_int_normalize(num);
+    return 0;
+}
+
+/* t = a * b / R, CIOS with the accumulator sliding up one slot
+ * each round instead of shifting it down */
+static slot_t *__big_int_mont_mul_slots(big_int_mont_ctx_t *ctx, const slot_t *a, const slot_t *b)
+{
+    size_t i, k = ctx->k;
+    slot_t *n = ctx->modulus->slot;
+    slot_t *u, carry, m;
+    uint64_t tmp;
+
+    for (i = 0; i != (k << 1) + 2; i++) ctx->t[i] = 0;
+    for (i = 0; i != k; i++)
+    {
+        u = ctx->t + i;
+        /* u += a * b[i] */
+        carry = __big_int_slots_addmul_1(u, a, k, b[i]);
+        tmp = (uint64_t)u[k] + carry;
+        u[k] = (slot_t)tmp;
+        u[k + 1] = (slot_t)(tmp >> BIT_PER_SLOT);
+        /* u += m * n, makes u[0] zero */
+        m = u[0] * ctx->n_inv;
+        carry = __big_int_slots_addmul_1(u, n, k, m);
+        tmp = (uint64_t)u[k] + carry;
+        u[k] = (slot_t)tmp;
+        u[k + 1] += (slot_t)(tmp >> BIT_PER_SLOT);
+    }
+    return ctx->t + k;
+}
+
+/* t = a^2 / R, the square first and then the reduction */
+static slot_t *__big_int_mont_sqr_slots(big_int_mont_ctx_t *ctx, const slot_t *a)
+{
+    size_t i, j, k = ctx->k;
+    slot_t *n = ctx->modulus->slot;
+    slot_t *t = ctx->t, carry, m;
+    uint64_t tmp;
+
+    __big_int_slots_sqr(t, a, k);
+    t[k << 1] = t[(k << 1) + 1] = 0;
+    for (i = 0; i != k; i++)
+    {
+        m = t[i] * ctx->n_inv;
+        carry = __big_int_slots_addmul_1(t + i, n, k, m);
+        for (j = i + k; carry != 0; j++)
+        {
+            tmp = (uint64_t)t[j] + carry;
+            t[j] = (slot_t)tmp;
+            carry = (slot_t)(tmp >> BIT_PER_SLOT);
+        }
+    }
+    return t + k;
+}
+
+int big_int_mont_mulmod(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    if (a == b) return big_int_mont_sqrmod(ctx, r, a);
+    if (__big_int_mont_load(ctx, ctx->a, a) != 0) return -1;
+    if (__big_int_mont_load(ctx, ctx->b, b) != 0) return -1;
+    return __big_int_mont_store(ctx, r, __big_int_mont_mul_slots(ctx, ctx->a, ctx->b));
+}
+
+int big_int_mont_sqrmod(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    if (__big_int_mont_load(ctx, ctx->a, a) != 0) return -1;
+    return __big_int_mont_store(ctx, r, __big_int_mont_sqr_slots(ctx, ctx->a));
+}
+
+/* a copy of the context running on the caller's scratch,
+ * the context itself is only read */
+static void __big_int_mont_borrow(big_int_mont_ctx_t *local, big_int_mont_ctx_t *ctx, slot_t *scratch)
+{
+    *local = *ctx;
+    local->a = scratch;
+    local->b = scratch + ctx->k;
+    local->t = scratch + (ctx->k << 1);
+}
+
+size_t big_int_mont_scratch_size(big_int_mont_ctx_t *ctx)
+{
+    return (ctx->k << 2) + 2;
+}
+
+int big_int_mont_mulmod_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    big_int_mont_ctx_t local;
+
+    __big_int_mont_borrow(&local, ctx, scratch);
+    return big_int_mont_mulmod(&local, r, a, b);
+}
+
+int big_int_mont_sqrmod_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a)
+{
+    big_int_mont_ctx_t local;
+
+    __big_int_mont_borrow(&local, ctx, scratch);
+    return big_int_mont_sqrmod(&local, r, a);
+}
+
+int big_int_mont_to_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a)
+{
+    big_int_mont_ctx_t local;
+
+    __big_int_mont_borrow(&local, ctx, scratch);
+    return big_int_mont_to(&local, r, a);
+}
+
+int big_int_mont_from_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a)
+{
+    big_int_mont_ctx_t local;
+
+    __big_int_mont_borrow(&local, ctx, scratch);
+    return big_int_mont_from(&local, r, a);
+}
+
+/* a * R = MontMul(a, R^2) */
+int big_int_mont_to(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    return big_int_mont_mulmod(ctx, r, a, ctx->r2);
+}
+
+/* a / R = MontMul(a, 1) */
+int big_int_mont_from(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    size_t i;
+
+    if (__big_int_mont_load(ctx, ctx->a, a) != 0) return -1;
+    ctx->b[0] = 1;
+    for (i = 1; i != ctx->k; i++) ctx->b[i] = 0;
+    return __big_int_mont_store(ctx, r, __big_int_mont_mul_slots(ctx, ctx->a, ctx->b));
+}
+
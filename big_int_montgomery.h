@@ -0,0 +1,60 @@
+/*
+   Big Integer Library - Montgomery Multiplication
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_MONTGOMERY_H_
+#define _BIG_INT_MONTGOMERY_H_
+
+#include "big_int.h"
+
+/* Montgomery multiplication context for a fixed odd modulus n,
+ * R = 2^(32k) with k the slots of n, values in Montgomery form
+ * are a * R mod n */
+typedef struct big_int_mont_ctx big_int_mont_ctx_t;
+
+big_int_mont_ctx_t *big_int_mont_ctx_new(big_int_t *modulus); /* odd modulus > 0 */
+int big_int_mont_ctx_destroy(big_int_mont_ctx_t *ctx);
+big_int_t *big_int_mont_ctx_modulus(big_int_mont_ctx_t *ctx);
+
+/* r = a * R mod n, and r = a / R mod n back */
+int big_int_mont_to(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a);
+int big_int_mont_from(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a);
+
+/* r = a * b / R mod n */
+int big_int_mont_mulmod(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b);
+int big_int_mont_sqrmod(big_int_mont_ctx_t *ctx, big_int_t *r, big_int_t *a);
+
+/* The same on scratch of big_int_mont_scratch_size() slots from the
+ * caller, the context is only read, so threads can share it */
+size_t big_int_mont_scratch_size(big_int_mont_ctx_t *ctx);
+int big_int_mont_mulmod_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a, big_int_t *b);
+int big_int_mont_sqrmod_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a);
+int big_int_mont_to_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a);
+int big_int_mont_from_with(big_int_mont_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a);
+
+#endif 
+
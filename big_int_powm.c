@@ -0,0 +1,978 @@
+/*
+   Big Integer Library - Modular Exponentiation
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+#include "big_int_montgomery.h"
+#include "big_int_special.h"
+#include "big_int_ctx_cache.h"
+#include "big_int_worker_pool.h"
+#include "big_int_powm.h"
+
+#define BIT_PER_SLOT (32)
+
+/* the reduction for mod, taken from the cache entry when there is one */
+static int __big_int_powm_ctx_choose(big_int_powm_ctx_t *ctx, big_int_t *mod)
+{
+    /* special form modulus first, folding beats both of the others */
+    if (ctx->entry != NULL) ctx->u.special = big_int_ctx_cache_special(ctx->entry);
+    else ctx->u.special = big_int_special_ctx_new(mod);
+    if (ctx->u.special != NULL)
+    {
+        ctx->type = BIG_INT_POWM_SPECIAL;
+        return 0;
+    }
+    if ((mod->slot[0] & 1) != 0)
+    {
+        ctx->type = BIG_INT_POWM_MONTGOMERY;
+        if (ctx->entry != NULL) ctx->u.mont = big_int_ctx_cache_mont(ctx->entry);
+        else ctx->u.mont = big_int_mont_ctx_new(mod);
+        if (ctx->u.mont != NULL) return 0;
+    }
+    else
+    {
+        ctx->type = BIG_INT_POWM_BARRETT;
+        if (ctx->entry != NULL) ctx->u.barrett = big_int_ctx_cache_barrett(ctx->entry);
+        else ctx->u.barrett = big_int_barrett_ctx_new(mod);
+        if (ctx->u.barrett != NULL) return 0;
+    }
+    return -1;
+}
+
+/* internal use only */
+int __big_int_powm_ctx_init(big_int_powm_ctx_t *ctx, big_int_t *mod)
+{
+    ctx->entry = big_int_ctx_cache_acquire(mod);
+    ctx->scratch = NULL;
+    if (__big_int_powm_ctx_choose(ctx, mod) == 0) return 0;
+    if (ctx->entry != NULL) big_int_ctx_cache_release(ctx->entry);
+    return -1;
+}
+
+/* a context of its own, kept out of the cache */
+static int __big_int_powm_ctx_init_owned(big_int_powm_ctx_t *ctx, big_int_t *mod)
+{
+    ctx->entry = NULL;
+    ctx->scratch = NULL;
+    return __big_int_powm_ctx_choose(ctx, mod);
+}
+
+/* internal use only */
+void __big_int_powm_ctx_uninit(big_int_powm_ctx_t *ctx)
+{
+    if (ctx->entry != NULL)
+    {
+        big_int_ctx_cache_release(ctx->entry);
+        return;
+    }
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY: big_int_mont_ctx_destroy(ctx->u.mont); break;
+        case BIG_INT_POWM_BARRETT: big_int_barrett_ctx_destroy(ctx->u.barrett); break;
+        case BIG_INT_POWM_SPECIAL: big_int_special_ctx_destroy(ctx->u.special); break;
+    }
+}
+
+/* internal use only */
+/* slots of scratch for a context that runs on the caller's scratch */
+size_t __big_int_powm_scratch_size(big_int_powm_ctx_t *ctx)
+{
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY: return big_int_mont_scratch_size(ctx->u.mont);
+        case BIG_INT_POWM_BARRETT: return big_int_barrett_scratch_size(ctx->u.barrett);
+        case BIG_INT_POWM_SPECIAL: return big_int_special_scratch_size(ctx->u.special);
+    }
+    return 0;
+}
+
+/* internal use only */
+/* r = a * b in the working domain */
+int __big_int_powm_mul(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    if (ctx->scratch != NULL)
+    {
+        switch (ctx->type)
+        {
+            case BIG_INT_POWM_MONTGOMERY: return big_int_mont_mulmod_with(ctx->u.mont, ctx->scratch, r, a, b);
+            case BIG_INT_POWM_BARRETT: return big_int_barrett_mulmod_with(ctx->u.barrett, ctx->scratch, r, a, b);
+            case BIG_INT_POWM_SPECIAL: return big_int_special_mulmod_with(ctx->u.special, ctx->scratch, r, a, b);
+        }
+        return -1;
+    }
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY: return big_int_mont_mulmod(ctx->u.mont, r, a, b);
+        case BIG_INT_POWM_BARRETT: return big_int_barrett_mulmod(ctx->u.barrett, r, a, b);
+        case BIG_INT_POWM_SPECIAL: return big_int_special_mulmod(ctx->u.special, r, a, b);
+    }
+    return -1;
+}
+
+/* internal use only */
+/* r = a^2 in the working domain */
+int __big_int_powm_sqr(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    if (ctx->scratch != NULL)
+    {
+        switch (ctx->type)
+        {
+            case BIG_INT_POWM_MONTGOMERY: return big_int_mont_sqrmod_with(ctx->u.mont, ctx->scratch, r, a);
+            case BIG_INT_POWM_BARRETT: return big_int_barrett_sqrmod_with(ctx->u.barrett, ctx->scratch, r, a);
+            case BIG_INT_POWM_SPECIAL: return big_int_special_sqrmod_with(ctx->u.special, ctx->scratch, r, a);
+        }
+        return -1;
+    }
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY: return big_int_mont_sqrmod(ctx->u.mont, r, a);
+        case BIG_INT_POWM_BARRETT: return big_int_barrett_sqrmod(ctx->u.barrett, r, a);
+        case BIG_INT_POWM_SPECIAL: return big_int_special_sqrmod(ctx->u.special, r, a);
+    }
+    return -1;
+}
+
+/* internal use only */
+/* r = a reduced and moved into the working domain */
+int __big_int_powm_enter(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY:
+            if (ctx->scratch != NULL) return big_int_mont_to_with(ctx->u.mont, ctx->scratch, r, a);
+            return big_int_mont_to(ctx->u.mont, r, a);
+        case BIG_INT_POWM_BARRETT:
+            if (big_int_assign_to(r, a) != 0) return -1;
+            if (ctx->scratch != NULL) return big_int_barrett_reduce_with(ctx->u.barrett, ctx->scratch, r);
+            return big_int_barrett_reduce(ctx->u.barrett, r);
+        case BIG_INT_POWM_SPECIAL:
+            if (big_int_assign_to(r, a) != 0) return -1;
+            if (ctx->scratch != NULL) return big_int_special_reduce_with(ctx->u.special, ctx->scratch, r);
+            return big_int_special_reduce(ctx->u.special, r);
+    }
+    return -1;
+}
+
+/* r = a moved out of the working domain */
+static int __big_int_powm_leave(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    switch (ctx->type)
+    {
+        case BIG_INT_POWM_MONTGOMERY:
+            if (ctx->scratch != NULL) return big_int_mont_from_with(ctx->u.mont, ctx->scratch, r, a);
+            return big_int_mont_from(ctx->u.mont, r, a);
+        case BIG_INT_POWM_BARRETT:
+        case BIG_INT_POWM_SPECIAL:
+            return big_int_assign_to(r, a);
+    }
+    return -1;
+}
+
+#define BIG_INT_EXP_BIT(exp, idx) (((exp)->slot[(idx) / BIT_PER_SLOT] >> ((idx) % BIT_PER_SLOT)) & 1)
+
+/* Sliding window of at most BIG_INT_POWM_WINDOW_MAX bits, the table
+ * holds the odd powers x, x^3, ..., x^(2^w - 1) */
+#define BIG_INT_POWM_WINDOW_MAX 7
+
+static size_t __big_int_powm_window_size(size_t bits)
+{
+    /* window cost 2^(w-1) muls for the table against bits / (w+1) muls
+     * in the scan */
+    if (bits <= 7) return 1;
+    if (bits <= 25) return 2;
+    if (bits <= 81) return 3;
+    if (bits <= 241) return 4;
+    if (bits <= 673) return 5;
+    if (bits <= 1793) return 6;
+    return BIG_INT_POWM_WINDOW_MAX;
+}
+
+/* r = base ^ exp in the context of the modulus, exp > 0 */
+static int __big_int_powm_with_ctx(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *base, big_int_t *exp)
+{
+    int ret = -1;
+    int started = 0;
+    size_t bit_idx, low_idx, idx;
+    size_t window, table_size = 0;
+    slot_t value;
+    big_int_t *table[1 << (BIG_INT_POWM_WINDOW_MAX - 1)];
+    big_int_t *x2 = NULL, *acc = NULL;
+
+    if ((acc = big_int_new_from_int(0)) == NULL) goto fail;
+
+    /* table of odd powers */
+    window = __big_int_powm_window_size(exp->bit_length);
+    if ((table[0] = big_int_new_from_int(0)) == NULL) goto fail;
+    table_size = 1;
+    if (__big_int_powm_enter(ctx, table[0], base) != 0) goto fail;
+    if (window > 1)
+    {
+        if ((x2 = big_int_new_from_int(0)) == NULL) goto fail;
+        if (__big_int_powm_sqr(ctx, x2, table[0]) != 0) goto fail;
+        while (table_size != ((size_t)1 << (window - 1)))
+        {
+            if ((table[table_size] = big_int_new_from_int(0)) == NULL) goto fail;
+            table_size++;
+            if (__big_int_powm_mul(ctx, table[table_size - 1], table[table_size - 2], x2) != 0) goto fail;
+        }
+    }
+
+    /* left-to-right sliding window, bit_idx is one past the next bit */
+    bit_idx = exp->bit_length;
+    while (bit_idx != 0)
+    {
+        if (!BIG_INT_EXP_BIT(exp, bit_idx - 1))
+        {
+            if (__big_int_powm_sqr(ctx, acc, acc) != 0) goto fail;
+            bit_idx--;
+            continue;
+        }
+        /* longest window ending in a set bit */
+        low_idx = (bit_idx > window) ? (bit_idx - window) : 0;
+        while (!BIG_INT_EXP_BIT(exp, low_idx)) low_idx++;
+        value = 0;
+        for (idx = bit_idx; idx-- != low_idx;)
+        {
+            value = (value << 1) | BIG_INT_EXP_BIT(exp, idx);
+            if (started)
+            {
+                if (__big_int_powm_sqr(ctx, acc, acc) != 0) goto fail;
+            }
+        }
+        if (started)
+        {
+            if (__big_int_powm_mul(ctx, acc, acc, table[value >> 1]) != 0) goto fail;
+        }
+        else
+        {
+            if (big_int_assign_to(acc, table[value >> 1]) != 0) goto fail;
+            started = 1;
+        }
+        bit_idx = low_idx;
+    }
+    if (__big_int_powm_leave(ctx, r, acc) != 0) goto fail;
+    ret = 0;
+fail:
+    while (table_size != 0) big_int_destroy(table[--table_size]);
+    if (x2 != NULL) big_int_destroy(x2);
+    if (acc != NULL) big_int_destroy(acc);
+    return ret;
+}
+
+int big_int_powm(big_int_t *r, big_int_t *base, big_int_t *exp, big_int_t *mod)
+{
+    int ret = -1;
+    big_int_powm_ctx_t ctx;
+    big_int_t *m = NULL, *acc = NULL;
+
+    if (big_int_is_zero(mod) || (exp->sign == BIG_NUMBER_NEGATIVE)) return -1;
+    if ((m = big_int_assign(mod)) == NULL) return -1;
+    m->sign = BIG_NUMBER_POSITIVE;
+    if (big_int_is_zero(exp))
+    {
+        /* x ^ 0 = 1 */
+        if ((acc = big_int_new_from_int(1)) == NULL) goto fail;
+        if (big_int_mod_to(acc, m) != 0) goto fail;
+        if (big_int_assign_to(r, acc) != 0) goto fail;
+        ret = 0;
+        goto fail;
+    }
+
+    if (__big_int_powm_ctx_init(&ctx, m) != 0) goto fail;
+    ret = __big_int_powm_with_ctx(&ctx, r, base, exp);
+    __big_int_powm_ctx_uninit(&ctx);
+fail:
+    if (m != NULL) big_int_destroy(m);
+    if (acc != NULL) big_int_destroy(acc);
+    return ret;
+}
+
+/* scratch NULL runs on the context's own */
+static int __big_int_powm_mont(big_int_mont_ctx_t *mont, slot_t *scratch, big_int_t *r, big_int_t *base, big_int_t *exp)
+{
+    int ret;
+    big_int_powm_ctx_t ctx;
+    big_int_t *acc;
+
+    if (exp->sign == BIG_NUMBER_NEGATIVE) return -1;
+    if (big_int_is_zero(exp))
+    {
+        /* x ^ 0 = 1 */
+        if ((acc = big_int_new_from_int(1)) == NULL) return -1;
+        ret = big_int_mod_to(acc, big_int_mont_ctx_modulus(mont));
+        if (ret == 0) ret = big_int_assign_to(r, acc);
+        big_int_destroy(acc);
+        return ret;
+    }
+    /* borrowed, never released here */
+    ctx.type = BIG_INT_POWM_MONTGOMERY;
+    ctx.u.mont = mont;
+    ctx.entry = NULL;
+    ctx.scratch = scratch;
+    return __big_int_powm_with_ctx(&ctx, r, base, exp);
+}
+
+int big_int_powm_mont(big_int_mont_ctx_t *mont, big_int_t *r, big_int_t *base, big_int_t *exp)
+{
+    return __big_int_powm_mont(mont, NULL, r, base, exp);
+}
+
+int big_int_powm_mont_with(big_int_mont_ctx_t *mont, slot_t *scratch, big_int_t *r, big_int_t *base, big_int_t *exp)
+{
+    return __big_int_powm_mont(mont, scratch, r, base, exp);
+}
+
+/* Lim-Lee comb: the exponent is cut into h rows of d bits,
+ * table[b] = prod g^(2^(j*d)) over the set bits j of b, so one
+ * column of the comb costs a square and a multiplication */
+#define BIG_INT_FIXED_BASE_TEETH_MAX 8
+
+struct big_int_fixed_base_ctx
+{
+    big_int_powm_ctx_t pctx; /* own reduction, only read after the table is built */
+    int pctx_ready;
+    size_t scratch_size; /* slots of per call scratch */
+    size_t exp_bits;
+    size_t teeth; /* h */
+    size_t spacing; /* d */
+    big_int_t *base;
+    big_int_t *modulus;
+    big_int_t **table; /* 2^h entries in the working domain, [0] unused */
+};
+
+static size_t __big_int_fixed_base_teeth(size_t bits)
+{
+    if (bits <= 32) return 3;
+    if (bits <= 128) return 5;
+    if (bits <= 512) return 7;
+    return BIG_INT_FIXED_BASE_TEETH_MAX;
+}
+
+big_int_fixed_base_ctx_t *big_int_fixed_base_ctx_new(big_int_t *base, big_int_t *mod, size_t exp_bits)
+{
+    size_t i, j, entries;
+    big_int_powm_ctx_t *pctx;
+    big_int_fixed_base_ctx_t *new_ctx = NULL;
+
+    if (big_int_is_zero(mod) || (exp_bits == 0)) return NULL;
+    if ((new_ctx = (big_int_fixed_base_ctx_t *)malloc(sizeof(big_int_fixed_base_ctx_t))) == NULL) return NULL;
+    new_ctx->pctx_ready = 0;
+    new_ctx->exp_bits = exp_bits;
+    new_ctx->teeth = __big_int_fixed_base_teeth(exp_bits);
+    new_ctx->spacing = (exp_bits + new_ctx->teeth - 1) / new_ctx->teeth;
+    new_ctx->base = NULL;
+    new_ctx->table = NULL;
+    entries = (size_t)1 << new_ctx->teeth;
+    if ((new_ctx->modulus = big_int_assign(mod)) == NULL) goto fail;
+    new_ctx->modulus->sign = BIG_NUMBER_POSITIVE;
+    if ((new_ctx->base = big_int_assign(base)) == NULL) goto fail;
+    if ((new_ctx->table = (big_int_t **)malloc(sizeof(big_int_t *) * entries)) == NULL) goto fail;
+    for (i = 0; i != entries; i++) new_ctx->table[i] = NULL;
+    for (i = 1; i != entries; i++)
+    {
+        if ((new_ctx->table[i] = big_int_new_from_int(0)) == NULL) goto fail;
+    }
+
+    pctx = &new_ctx->pctx;
+    if (__big_int_powm_ctx_init_owned(pctx, new_ctx->modulus) != 0) goto fail;
+    new_ctx->pctx_ready = 1;
+    new_ctx->scratch_size = __big_int_powm_scratch_size(pctx);
+    /* table[2^j] = g^(2^(j*d)) */
+    if (__big_int_powm_enter(pctx, new_ctx->table[1], base) != 0) goto fail;
+    for (j = 1; j != new_ctx->teeth; j++)
+    {
+        if (big_int_assign_to(new_ctx->table[(size_t)1 << j], new_ctx->table[(size_t)1 << (j - 1)]) != 0) goto fail;
+        for (i = 0; i != new_ctx->spacing; i++)
+        {
+            if (__big_int_powm_sqr(pctx, new_ctx->table[(size_t)1 << j], new_ctx->table[(size_t)1 << j]) != 0) goto fail;
+        }
+    }
+    /* the other entries from the lower ones and the top row */
+    for (i = 3; i != entries; i++)
+    {
+        if ((i & (i - 1)) == 0) continue;
+        for (j = (size_t)1 << (new_ctx->teeth - 1); (i & j) == 0; j >>= 1);
+        if (__big_int_powm_mul(pctx, new_ctx->table[i], new_ctx->table[i ^ j], new_ctx->table[j]) != 0) goto fail;
+    }
+    return new_ctx;
+fail:
+    big_int_fixed_base_ctx_destroy(new_ctx);
+    return NULL;
+}
+
+int big_int_fixed_base_ctx_destroy(big_int_fixed_base_ctx_t *ctx)
+{
+    size_t i;
+
+    if (ctx == NULL) return 0;
+    if (ctx->table != NULL)
+    {
+        for (i = 1; i != ((size_t)1 << ctx->teeth); i++)
+        {
+            if (ctx->table[i] != NULL) big_int_destroy(ctx->table[i]);
+        }
+        free(ctx->table);
+    }
+    if (ctx->base != NULL) big_int_destroy(ctx->base);
+    if (ctx->modulus != NULL) big_int_destroy(ctx->modulus);
+    if (ctx->pctx_ready) __big_int_powm_ctx_uninit(&ctx->pctx);
+    free(ctx);
+    return 0;
+}
+
+int big_int_powm_fixed_base(big_int_fixed_base_ctx_t *ctx, big_int_t *r, big_int_t *exp)
+{
+    int ret = -1;
+    int started = 0;
+    size_t col, j, bit;
+    size_t value;
+    big_int_powm_ctx_t pctx;
+    big_int_t *acc = NULL;
+
+    if (exp->sign == BIG_NUMBER_NEGATIVE) return -1;
+    /* out of the table range */
+    if (big_int_is_zero(exp) || (exp->bit_length > ctx->exp_bits))
+    {
+        return big_int_powm(r, ctx->base, exp, ctx->modulus);
+    }
+
+    /* the shared reduction is only read, on scratch of this call */
+    pctx = ctx->pctx;
+    if ((pctx.scratch = (slot_t *)calloc(ctx->scratch_size, sizeof(slot_t))) == NULL) return -1;
+    if ((acc = big_int_new_from_int(0)) == NULL) goto fail;
+    for (col = ctx->spacing; col-- != 0;)
+    {
+        if (started)
+        {
+            if (__big_int_powm_sqr(&pctx, acc, acc) != 0) goto fail;
+        }
+        value = 0;
+        for (j = ctx->teeth; j-- != 0;)
+        {
+            bit = j * ctx->spacing + col;
+            value <<= 1;
+            if (bit < exp->bit_length) value |= BIG_INT_EXP_BIT(exp, bit);
+        }
+        if (value == 0) continue;
+        if (started)
+        {
+            if (__big_int_powm_mul(&pctx, acc, acc, ctx->table[value]) != 0) goto fail;
+        }
+        else
+        {
+            if (big_int_assign_to(acc, ctx->table[value]) != 0) goto fail;
+            started = 1;
+        }
+    }
+    if (__big_int_powm_leave(&pctx, r, acc) != 0) goto fail;
+    ret = 0;
+fail:
+    free(pctx.scratch);
+    if (acc != NULL) big_int_destroy(acc);
+    return ret;
+}
+
+/* bits [low, low + count) of exp, count <= 16 */
+static size_t __big_int_powm_exp_digit(big_int_t *exp, size_t low, size_t count)
+{
+    size_t value = 0;
+    size_t idx;
+
+    for (idx = low + count; idx-- != low;)
+    {
+        value <<= 1;
+        if (idx < exp->bit_length) value |= BIG_INT_EXP_BIT(exp, idx);
+    }
+    return value;
+}
+
+/* acc = acc * a, or acc = a when nothing has been multiplied in yet */
+static int __big_int_powm_mul_in(big_int_powm_ctx_t *ctx, big_int_t *acc, int *started, big_int_t *a)
+{
+    if (*started) return __big_int_powm_mul(ctx, acc, acc, a);
+    *started = 1;
+    return big_int_assign_to(acc, a);
+}
+
+/* Straus: one sliding window of odd powers per base, the windows are
+ * interleaved over a single chain of squarings */
+typedef struct
+{
+    size_t window;
+    size_t next; /* one past the next unscanned bit */
+    size_t mul_at; /* low bit of the pending window */
+    size_t value; /* pending window, 0 for none */
+    big_int_t **table;
+} big_int_powm_straus_t;
+
+static int __big_int_powm_multi_straus(big_int_powm_ctx_t *ctx, big_int_t *acc, int *started, \
+        big_int_t **bases, big_int_t **exps, size_t count, size_t max_bits)
+{
+    int ret = -1;
+    size_t i, j, bit_idx, entries = 0, used = 0;
+    big_int_powm_straus_t *state = NULL;
+    big_int_t **tables = NULL;
+    big_int_t *x2 = NULL;
+
+    if ((state = (big_int_powm_straus_t *)malloc(sizeof(big_int_powm_straus_t) * count)) == NULL) return -1;
+    for (i = 0; i != count; i++)
+    {
+        state[i].window = __big_int_powm_window_size(exps[i]->bit_length);
+        state[i].next = exps[i]->bit_length;
+        state[i].value = 0;
+        entries += (size_t)1 << (state[i].window - 1);
+    }
+    if ((tables = (big_int_t **)malloc(sizeof(big_int_t *) * entries)) == NULL) goto fail;
+    if ((x2 = big_int_new_from_int(0)) == NULL) goto fail;
+    for (i = 0; i != count; i++)
+    {
+        state[i].table = tables + used;
+        for (j = 0; j != ((size_t)1 << (state[i].window - 1)); j++)
+        {
+            if ((tables[used] = big_int_new_from_int(0)) == NULL) goto fail;
+            used++;
+            if (j == 0)
+            {
+                if (__big_int_powm_enter(ctx, state[i].table[0], bases[i]) != 0) goto fail;
+                if (state[i].window > 1)
+                {
+                    if (__big_int_powm_sqr(ctx, x2, state[i].table[0]) != 0) goto fail;
+                }
+            }
+            else
+            {
+                if (__big_int_powm_mul(ctx, state[i].table[j], state[i].table[j - 1], x2) != 0) goto fail;
+            }
+        }
+    }
+
+    for (bit_idx = max_bits; bit_idx-- != 0;)
+    {
+        if (*started)
+        {
+            if (__big_int_powm_sqr(ctx, acc, acc) != 0) goto fail;
+        }
+        for (i = 0; i != count; i++)
+        {
+            if ((state[i].value == 0) && (bit_idx < state[i].next) && BIG_INT_EXP_BIT(exps[i], bit_idx))
+            {
+                /* window [low, bit_idx] ending in a set bit */
+                j = (bit_idx + 1 > state[i].window) ? (bit_idx + 1 - state[i].window) : 0;
+                while (!BIG_INT_EXP_BIT(exps[i], j)) j++;
+                state[i].value = __big_int_powm_exp_digit(exps[i], j, bit_idx + 1 - j);
+                state[i].mul_at = j;
+                state[i].next = j;
+            }
+            if ((state[i].value != 0) && (state[i].mul_at == bit_idx))
+            {
+                if (__big_int_powm_mul_in(ctx, acc, started, state[i].table[state[i].value >> 1]) != 0) goto fail;
+                state[i].value = 0;
+            }
+        }
+    }
+    ret = 0;
+fail:
+    while (used != 0) big_int_destroy(tables[--used]);
+    if (tables != NULL) free(tables);
+    if (x2 != NULL) big_int_destroy(x2);
+    free(state);
+    return ret;
+}
+
+/* Pippenger: c bit digits of every exponent are sorted into buckets,
+ * prod B[d]^d is taken with two running products */
+static int __big_int_powm_multi_pippenger(big_int_powm_ctx_t *ctx, big_int_t *acc, int *started, \
+        big_int_t **bases, big_int_t **exps, size_t count, size_t max_bits, size_t digit_bits)
+{
+    int ret = -1;
+    int running_used, total_used;
+    size_t i, d, digit_idx, buckets = (size_t)1 << digit_bits;
+    int *bucket_used = NULL;
+    big_int_t **x = NULL, **bucket = NULL;
+    big_int_t *running = NULL, *total = NULL;
+
+    if ((x = (big_int_t **)malloc(sizeof(big_int_t *) * count)) == NULL) return -1;
+    for (i = 0; i != count; i++) x[i] = NULL;
+    if ((bucket = (big_int_t **)malloc(sizeof(big_int_t *) * buckets)) == NULL) goto fail;
+    for (d = 0; d != buckets; d++) bucket[d] = NULL;
+    if ((bucket_used = (int *)malloc(sizeof(int) * buckets)) == NULL) goto fail;
+    for (i = 0; i != count; i++)
+    {
+        if ((x[i] = big_int_new_from_int(0)) == NULL) goto fail;
+        if (__big_int_powm_enter(ctx, x[i], bases[i]) != 0) goto fail;
+    }
+    for (d = 1; d != buckets; d++)
+    {
+        if ((bucket[d] = big_int_new_from_int(0)) == NULL) goto fail;
+    }
+    if ((running = big_int_new_from_int(0)) == NULL) goto fail;
+    if ((total = big_int_new_from_int(0)) == NULL) goto fail;
+
+    for (digit_idx = (max_bits + digit_bits - 1) / digit_bits; digit_idx-- != 0;)
+    {
+        if (*started)
+        {
+            for (d = 0; d != digit_bits; d++)
+            {
+                if (__big_int_powm_sqr(ctx, acc, acc) != 0) goto fail;
+            }
+        }
+        for (d = 1; d != buckets; d++) bucket_used[d] = 0;
+        for (i = 0; i != count; i++)
+        {
+            d = __big_int_powm_exp_digit(exps[i], digit_idx * digit_bits, digit_bits);
+            if (d == 0) continue;
+            if (__big_int_powm_mul_in(ctx, bucket[d], &bucket_used[d], x[i]) != 0) goto fail;
+        }
+        running_used = 0;
+        total_used = 0;
+        for (d = buckets; --d != 0;)
+        {
+            if (bucket_used[d])
+            {
+                if (__big_int_powm_mul_in(ctx, running, &running_used, bucket[d]) != 0) goto fail;
+            }
+            if (running_used)
+            {
+                if (__big_int_powm_mul_in(ctx, total, &total_used, running) != 0) goto fail;
+            }
+        }
+        if (total_used)
+        {
+            if (__big_int_powm_mul_in(ctx, acc, started, total) != 0) goto fail;
+        }
+    }
+    ret = 0;
+fail:
+    for (i = 0; i != count; i++)
+    {
+        if (x[i] != NULL) big_int_destroy(x[i]);
+    }
+    free(x);
+    if (bucket != NULL)
+    {
+        for (d = 1; d != buckets; d++)
+        {
+            if (bucket[d] != NULL) big_int_destroy(bucket[d]);
+        }
+        free(bucket);
+    }
+    if (bucket_used != NULL) free(bucket_used);
+    if (running != NULL) big_int_destroy(running);
+    if (total != NULL) big_int_destroy(total);
+    return ret;
+}
+
+#define BIG_INT_POWM_PIPPENGER_DIGIT_MAX 16
+
+int big_int_powm_multi(big_int_t *r, big_int_t **bases, big_int_t **exps, size_t count, big_int_t *mod)
+{
+    int ret = -1;
+    int started = 0;
+    size_t i, digit_bits, best_digit_bits = 0;
+    size_t max_bits = 0;
+    size_t cost, straus_cost = 0, pippenger_cost = (size_t)-1;
+    big_int_powm_ctx_t ctx;
+    big_int_t *m = NULL, *acc = NULL;
+
+    if (big_int_is_zero(mod)) return -1;
+    for (i = 0; i != count; i++)
+    {
+        if (exps[i]->sign == BIG_NUMBER_NEGATIVE) return -1;
+        if (big_int_is_zero(exps[i])) continue;
+        if (exps[i]->bit_length > max_bits) max_bits = exps[i]->bit_length;
+    }
+    if ((m = big_int_assign(mod)) == NULL) return -1;
+    m->sign = BIG_NUMBER_POSITIVE;
+    if ((acc = big_int_new_from_int(1)) == NULL) goto fail;
+    if (max_bits == 0)
+    {
+        /* every exponent is 0 */
+        if (big_int_mod_to(acc, m) != 0) goto fail;
+        if (big_int_assign_to(r, acc) != 0) goto fail;
+        ret = 0;
+        goto fail;
+    }
+
+    /* multiplications of each method, the squarings are the same */
+    for (i = 0; i != count; i++)
+    {
+        digit_bits = __big_int_powm_window_size(exps[i]->bit_length);
+        straus_cost += ((size_t)1 << (digit_bits - 1)) + exps[i]->bit_length / (digit_bits + 1);
+    }
+    for (digit_bits = 1; digit_bits <= BIG_INT_POWM_PIPPENGER_DIGIT_MAX; digit_bits++)
+    {
+        cost = (max_bits + digit_bits - 1) / digit_bits * (count + ((size_t)2 << digit_bits));
+        if (cost < pippenger_cost)
+        {
+            pippenger_cost = cost;
+            best_digit_bits = digit_bits;
+        }
+    }
+
+    if (__big_int_powm_ctx_init(&ctx, m) != 0) goto fail;
+    if (pippenger_cost < straus_cost)
+    {
+        if (__big_int_powm_multi_pippenger(&ctx, acc, &started, bases, exps, count, max_bits, best_digit_bits) != 0) goto uninit;
+    }
+    else
+    {
+        if (__big_int_powm_multi_straus(&ctx, acc, &started, bases, exps, count, max_bits) != 0) goto uninit;
+    }
+    /* some exponent is nonzero, so acc has been started */
+    if (__big_int_powm_leave(&ctx, r, acc) != 0) goto uninit;
+    ret = 0;
+uninit:
+    __big_int_powm_ctx_uninit(&ctx);
+fail:
+    if (m != NULL) big_int_destroy(m);
+    if (acc != NULL) big_int_destroy(acc);
+    return ret;
+}
+
+/* Batch: jobs are sorted by modulus, every distinct modulus gets one
+ * reduction context before the run, then the runs are cut into chunks
+ * for the workers, chunks of one modulus only read its context and
+ * bring their own scratch */
+typedef struct
+{
+    size_t start;
+    size_t length;
+    big_int_powm_ctx_t *ctx; /* NULL when the run has no context */
+} big_int_powm_chunk_t;
+
+typedef struct
+{
+    size_t idx;
+    big_int_t *mod;
+} big_int_powm_job_t;
+
+typedef struct
+{
+    big_int_t **results;
+    big_int_t **bases;
+    big_int_t **exps;
+    big_int_t **mods;
+    big_int_powm_job_t *order;
+    int *status;
+    big_int_powm_chunk_t *chunks;
+    big_int_powm_ctx_t *ctxs; /* one per distinct modulus */
+    size_t ctx_count;
+} big_int_powm_batch_t;
+
+/* compare |a| with |b| */
+static int __big_int_powm_abs_cmp(big_int_t *a, big_int_t *b)
+{
+    size_t idx;
+
+    if (a->slot_length != b->slot_length) return (a->slot_length < b->slot_length) ? -1 : 1;
+    for (idx = a->slot_length; idx-- != 0;)
+    {
+        if (a->slot[idx] != b->slot[idx]) return (a->slot[idx] < b->slot[idx]) ? -1 : 1;
+    }
+    return 0;
+}
+
+static int __big_int_powm_batch_cmp(const void *a, const void *b)
+{
+    const big_int_powm_job_t *job_a = (const big_int_powm_job_t *)a;
+    const big_int_powm_job_t *job_b = (const big_int_powm_job_t *)b;
+    int cmp = __big_int_powm_abs_cmp(job_a->mod, job_b->mod);
+
+    if (cmp != 0) return cmp;
+    return (job_a->idx < job_b->idx) ? -1 : (job_a->idx > job_b->idx);
+}
+
+static void __big_int_powm_batch_chunk(void *arg, size_t chunk_idx)
+{
+    big_int_powm_batch_t *batch = (big_int_powm_batch_t *)arg;
+    big_int_powm_chunk_t *chunk = &batch->chunks[chunk_idx];
+    size_t i, job;
+    big_int_powm_ctx_t ctx;
+
+    if (chunk->ctx != NULL)
+    {
+        ctx = *chunk->ctx;
+        if ((ctx.scratch = (slot_t *)calloc(__big_int_powm_scratch_size(&ctx), sizeof(slot_t))) == NULL) return;
+    }
+    for (i = chunk->start; i != chunk->start + chunk->length; i++)
+    {
+        job = batch->order[i].idx;
+        if ((chunk->ctx == NULL) || big_int_is_zero(batch->exps[job]) || \
+                (batch->exps[job]->sign == BIG_NUMBER_NEGATIVE))
+        {
+            /* nothing to share */
+            batch->status[job] = big_int_powm(batch->results[job], batch->bases[job], batch->exps[job], batch->mods[job]);
+            continue;
+        }
+        batch->status[job] = __big_int_powm_with_ctx(&ctx, batch->results[job], batch->bases[job], batch->exps[job]);
+    }
+    if (chunk->ctx != NULL) free(ctx.scratch);
+}
+
+int big_int_powm_batch(big_int_t **results, big_int_t **bases, big_int_t **exps, big_int_t **mods, \
+        size_t count, big_int_worker_pool_t *pool)
+{
+    int ret = -1;
+    size_t i, run_end, chunk_end, chunk_count = 0, chunk_max;
+    big_int_powm_batch_t batch;
+    big_int_powm_ctx_t *ctx;
+    big_int_t *m;
+
+    if (count == 0) return 0;
+    batch.results = results;
+    batch.bases = bases;
+    batch.exps = exps;
+    batch.mods = mods;
+    batch.chunks = NULL;
+    batch.status = NULL;
+    batch.ctxs = NULL;
+    batch.ctx_count = 0;
+    if ((batch.order = (big_int_powm_job_t *)malloc(sizeof(big_int_powm_job_t) * count)) == NULL) return -1;
+    if ((batch.status = (int *)malloc(sizeof(int) * count)) == NULL) goto fail;
+    if ((batch.chunks = (big_int_powm_chunk_t *)malloc(sizeof(big_int_powm_chunk_t) * count)) == NULL) goto fail;
+    if ((batch.ctxs = (big_int_powm_ctx_t *)malloc(sizeof(big_int_powm_ctx_t) * count)) == NULL) goto fail;
+    for (i = 0; i != count; i++)
+    {
+        batch.order[i].idx = i;
+        batch.order[i].mod = mods[i];
+        batch.status[i] = -1;
+    }
+    qsort(batch.order, count, sizeof(big_int_powm_job_t), __big_int_powm_batch_cmp);
+
+    /* a run of one modulus is split so that every thread gets work */
+    chunk_max = (pool != NULL) ? count / (big_int_worker_pool_threads(pool) + 1) : count;
+    if (chunk_max == 0) chunk_max = 1;
+    for (i = 0; i != count; i = run_end)
+    {
+        for (run_end = i + 1; (run_end != count) && \
+                (__big_int_powm_abs_cmp(batch.order[i].mod, batch.order[run_end].mod) == 0); run_end++);
+        ctx = NULL;
+        if (!big_int_is_zero(batch.order[i].mod))
+        {
+            if ((m = big_int_assign(batch.order[i].mod)) == NULL) goto fail;
+            m->sign = BIG_NUMBER_POSITIVE;
+            if (__big_int_powm_ctx_init(&batch.ctxs[batch.ctx_count], m) == 0) ctx = &batch.ctxs[batch.ctx_count++];
+            big_int_destroy(m);
+        }
+        for (; i != run_end; i = chunk_end)
+        {
+            chunk_end = (run_end - i > chunk_max) ? i + chunk_max : run_end;
+            batch.chunks[chunk_count].start = i;
+            batch.chunks[chunk_count].length = chunk_end - i;
+            batch.chunks[chunk_count].ctx = ctx;
+            chunk_count++;
+        }
+    }
+
+    if (pool != NULL)
+    {
+        if (big_int_worker_pool_run(pool, __big_int_powm_batch_chunk, &batch, chunk_count) != 0) goto fail;
+    }
+    else
+    {
+        for (i = 0; i != chunk_count; i++) __big_int_powm_batch_chunk(&batch, i);
+    }
+    ret = 0;
+    for (i = 0; i != count; i++)
+    {
+        if (batch.status[i] != 0) ret = -1;
+    }
+fail:
+    free(batch.order);
+    if (batch.status != NULL) free(batch.status);
+    if (batch.chunks != NULL) free(batch.chunks);
+    if (batch.ctxs != NULL)
+    {
+        for (i = 0; i != batch.ctx_count; i++) __big_int_powm_ctx_uninit(&batch.ctxs[i]);
+        free(batch.ctxs);
+    }
+    return ret;
+}
+
+/* a = 2a mod m for 0 <= a < m, a shift and at most one subtraction */
+static int __big_int_powm_double(big_int_t *a, big_int_t *m)
+{
+    if (big_int_is_zero(a)) return 0;
+    if (big_int_left_shift(a, 1) != 0) return -1;
+    if (__big_int_powm_abs_cmp(a, m) >= 0) return big_int_sub_to(a, m);
+    return 0;
+}
+
+int big_int_powm_2exp(big_int_t *r, big_int_t *exp, big_int_t *mod)
+{
+    int ret = -1;
+    size_t bit_idx, top_bits = 0;
+    big_int_powm_ctx_t ctx;
+    big_int_t *m = NULL, *acc = NULL;
+
+    if (big_int_is_zero(mod) || (exp->sign == BIG_NUMBER_NEGATIVE)) return -1;
+    if ((m = big_int_assign(mod)) == NULL) return -1;
+    m->sign = BIG_NUMBER_POSITIVE;
+    if ((acc = big_int_new_from_int(1)) == NULL) goto fail;
+    if (big_int_is_zero(exp) || (m->bit_length == 1))
+    {
+        /* 2 ^ 0 = 1, x mod 1 = 0 */
+        if (big_int_mod_to(acc, m) != 0) goto fail;
+        if (big_int_assign_to(r, acc) != 0) goto fail;
+        ret = 0;
+        goto fail;
+    }
+
+    /* the top bits of exp give a power 2^v < m directly, which saves
+     * the squarings of the small powers */
+    while ((top_bits < exp->bit_length) && (((size_t)2 << top_bits) - 1 <= m->bit_length - 2)) top_bits++;
+    bit_idx = exp->bit_length - top_bits;
+    if (top_bits != 0)
+    {
+        if (big_int_left_shift(acc, (int)__big_int_powm_exp_digit(exp, bit_idx, top_bits)) != 0) goto fail;
+    }
+
+    if (__big_int_powm_ctx_init(&ctx, m) != 0) goto fail;
+    if (__big_int_powm_enter(&ctx, acc, acc) != 0) goto uninit;
+    /* left-to-right binary method, multiplying by 2 is a doubling,
+     * the working domains are all linear so it is done in place */
+    while (bit_idx-- != 0)
+    {
+        if (__big_int_powm_sqr(&ctx, acc, acc) != 0) goto uninit;
+        if (BIG_INT_EXP_BIT(exp, bit_idx))
+        {
+            if (__big_int_powm_double(acc, m) != 0) goto uninit;
+        }
+    }
+    if (__big_int_powm_leave(&ctx, r, acc) != 0) goto uninit;
+    ret = 0;
+uninit:
+    __big_int_powm_ctx_uninit(&ctx);
+fail:
+    if (m != NULL) big_int_destroy(m);
+    if (acc != NULL) big_int_destroy(acc);
+    return ret;
+}
@@ -0,0 +1,112 @@
+/*
+   Big Integer Library - Modular Exponentiation
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_POWM_H_
+#define _BIG_INT_POWM_H_
+
+#include "big_int.h"
+#include "big_int_barrett.h"
+#include "big_int_montgomery.h"
+#include "big_int_special.h"
+#include "big_int_ctx_cache.h"
+#include "big_int_worker_pool.h"
+
+/* r = base ^ exp mod |mod|, 0 <= r < |mod|, exp >= 0
+ * special form modulus is reduced by folding, Montgomery
+ * multiplication is used for other odd modulus, Barrett reduction
+ * for the rest, the exponent is scanned with a sliding window of
+ * odd powers sized by the exponent length */
+int big_int_powm(big_int_t *r, big_int_t *base, big_int_t *exp, big_int_t *mod);
+
+/* r = 2 ^ exp mod |mod|, multiplying by the base is a doubling */
+int big_int_powm_2exp(big_int_t *r, big_int_t *exp, big_int_t *mod);
+
+/* r = base ^ exp mod n with the caller's Montgomery context for n,
+ * for callers that keep the context of a modulus they own */
+int big_int_powm_mont(big_int_mont_ctx_t *mont, big_int_t *r, big_int_t *base, big_int_t *exp);
+/* the same on zeroed scratch of big_int_mont_scratch_size() slots,
+ * the context is only read, so threads can share it */
+int big_int_powm_mont_with(big_int_mont_ctx_t *mont, slot_t *scratch, big_int_t *r, big_int_t *base, big_int_t *exp);
+
+/* Fixed base context, a comb table of base in the working domain of
+ * mod built once for exponents up to exp_bits, the context is only
+ * read by big_int_powm_fixed_base, so threads can share it */
+typedef struct big_int_fixed_base_ctx big_int_fixed_base_ctx_t;
+
+big_int_fixed_base_ctx_t *big_int_fixed_base_ctx_new(big_int_t *base, big_int_t *mod, size_t exp_bits);
+int big_int_fixed_base_ctx_destroy(big_int_fixed_base_ctx_t *ctx);
+
+/* r = base ^ exp mod |mod| as big_int_powm,
+ * exp longer than exp_bits falls back to big_int_powm */
+int big_int_powm_fixed_base(big_int_fixed_base_ctx_t *ctx, big_int_t *r, big_int_t *exp);
+
+/* r = prod bases[i] ^ exps[i] mod |mod|, 0 <= r < |mod|, exps[i] >= 0
+ * all powers share one chain of squarings, interleaved sliding
+ * windows (Straus) for few bases, buckets (Pippenger) for many */
+int big_int_powm_multi(big_int_t *r, big_int_t **bases, big_int_t **exps, size_t count, big_int_t *mod);
+
+/* results[i] = bases[i] ^ exps[i] mod |mods[i]| for independent jobs,
+ * jobs sharing a modulus share one reduction context, the jobs run on
+ * the pool (in the caller when NULL) and all are done on return,
+ * -1 if any job failed; results must not alias the inputs of other jobs */
+int big_int_powm_batch(big_int_t **results, big_int_t **bases, big_int_t **exps, big_int_t **mods, \
+        size_t count, big_int_worker_pool_t *pool);
+
+/* internal use only */
+/* Reduction used through one exponentiation, the context comes
+ * from the cache when the modulus is a repeated one */
+#define BIG_INT_POWM_MONTGOMERY 0
+#define BIG_INT_POWM_BARRETT 1
+#define BIG_INT_POWM_SPECIAL 2
+typedef struct
+{
+    int type;
+    union
+    {
+        big_int_mont_ctx_t *mont;
+        big_int_barrett_ctx_t *barrett;
+        big_int_special_ctx_t *special;
+    } u;
+    big_int_ctx_cache_entry_t *entry;
+    slot_t *scratch; /* caller's scratch, the reduction is then only read */
+} big_int_powm_ctx_t;
+
+/* special form, then Montgomery for odd mod, Barrett for the rest */
+int __big_int_powm_ctx_init(big_int_powm_ctx_t *ctx, big_int_t *mod);
+void __big_int_powm_ctx_uninit(big_int_powm_ctx_t *ctx);
+/* slots of zeroed scratch a context needs to run on the caller's */
+size_t __big_int_powm_scratch_size(big_int_powm_ctx_t *ctx);
+/* r = a * b in the working domain */
+int __big_int_powm_mul(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b);
+/* r = a^2 in the working domain */
+int __big_int_powm_sqr(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a);
+/* r = a reduced and moved into the working domain */
+int __big_int_powm_enter(big_int_powm_ctx_t *ctx, big_int_t *r, big_int_t *a);
+
+#endif 
+
@@ -27,53 +27,31 @@
    */
 
 #include "big_int.h"
+#include "big_int_powm.h"
 
-static int montgomery(big_int_t *n_in, big_int_t *p, big_int_t *m)
+/* n ^ p mod m == 1 */
+static int powm_is_one(big_int_t *n, big_int_t *p, big_int_t *m)
 {
     int ret;
-    int idx = 0;
-    big_int_t *n = NULL, *k = NULL;
-    big_int_t *barret = NULL;
-    n = big_int_assign(n_in);
-    if (n == NULL) {ret = -1; goto fail;}
-    /* k = 1*/
-    k = big_int_new_from_int(1);
-    if (k == NULL) {ret = -1; goto fail;}
-    /* build barret */
-    barret = big_int_barret_build(m);
-    /* n = n % m */
-    big_int_mod_to_with_barret(n, m, barret);
-    for (;;)
-    {
-        if (p->bit_length == 1 && p->slot_length == 1 && p->slot[0] == 1) break;
-        if ((p->slot[0] & 1) != 0)
-        {
-            /* k = (k * n) % m */
-            big_int_mul_to(k, n);
-            big_int_mod_to_with_barret(k, m, barret);
-        }
-        /* n = (n * n) % m */
-        big_int_mul_to(n, n);
-        big_int_mod_to_with_barret(n, m, barret);
-        /* p = p >> 1 */
-        big_int_right_shift(p, 1);
-        idx++;
-    }
-    /* n = (n * k) % m */
-    big_int_mul_to(n, k);
-    big_int_mod_to_with_barret(n, m, barret);
-    if (n->bit_length == 1 && n->slot_length == 1 && n->slot[0] == 1)
-    {
-        ret = 1;
-    }
-    else
-    {
-        ret = 0;
-    }
-fail:
-    if (barret != NULL) big_int_destroy(barret);
-    if (n != NULL) big_int_destroy(n);
-    if (k != NULL) big_int_destroy(k);
+    big_int_t *r = big_int_new_from_int(0);
+
+    if (r == NULL) return -1;
+    if (big_int_powm(r, n, p, m) != 0) ret = -1;
+    else ret = (r->slot_length == 1 && r->slot[0] == 1) ? 1 : 0;
+    big_int_destroy(r);
+    return ret;
+}
+
+/* 2 ^ p mod m == 1 */
+static int powm_2exp_is_one(big_int_t *p, big_int_t *m)
+{
+    int ret;
+    big_int_t *r = big_int_new_from_int(0);
+
+    if (r == NULL) return -1;
+    if (big_int_powm_2exp(r, p, m) != 0) ret = -1;
+    else ret = (r->slot_length == 1 && r->slot[0] == 1) ? 1 : 0;
+    big_int_destroy(r);
     return ret;
 }
 
@@ -87,7 +65,8 @@ int fermat(big_int_t *num, int a)
     if ((num_a == NULL) || (num_bak == NULL) || (num_dec == NULL)) { ret = -1; goto fail; }
     big_int_dec(num_dec);
     /* a ** (n - 1) === 1 (mod n) */
-    ret = (montgomery(num_a, num_dec, num_bak) == 1) ? 1 : 0;
+    if (a == 2) ret = (powm_2exp_is_one(num_dec, num_bak) == 1) ? 1 : 0;
+    else ret = (powm_is_one(num_a, num_dec, num_bak) == 1) ? 1 : 0;
 fail:
     if (num_a) big_int_destroy(num_a);
     if (num_bak) big_int_destroy(num_bak);
@@ -363,7 +342,8 @@ int prime_divide_test(big_int_t *num)
     for (i = 0; i < prime_table_size; i++)
     {
         count = 0;
-        for (slot_idx = 0; slot_idx != num->slot_length; slot_idx++)
+        /* from the most significant slot down */
+        for (slot_idx = num->slot_length; slot_idx-- != 0;)
         {
             count = (((uint64_t)count << 32) + num->slot[slot_idx]) % prime_table[i];
         }
@@ -378,33 +358,46 @@ int prime_divide_test(big_int_t *num)
 int miller_rabin_pass(big_int_t *num_a, big_int_t *num_s_in, big_int_t *num_d, big_int_t *num_n, 
         big_int_t *num_n_dec, big_int_t *num_n_barret)
 {
-    int ret;
-    big_int_t *num_t, *num_s;
-    num_s = big_int_assign(num_s_in);
-    num_t = big_int_assign(num_a);
-    big_int_pow_mod_to_with_barret(num_t, num_d, num_n, num_n_barret);
-    if (num_t->slot_length == 1 && num_t->slot[0] == 1)
+    int ret = 0;
+    int ctx_ready = 0;
+    size_t s, i;
+    big_int_powm_ctx_t ctx;
+    big_int_t *num_t, *num_minus_one = NULL;
+
+    /* num_n_barret is no longer used, the squarings run in the
+     * working domain of the exponentiation */
+    (void)num_n_barret;
+    if ((num_t = big_int_new_from_int(0)) == NULL) return 0;
+    if (num_a->slot_length == 1 && num_a->slot[0] == 2) big_int_powm_2exp(num_t, num_d, num_n);
+    else big_int_powm(num_t, num_a, num_d, num_n);
+    if ((num_t->slot_length == 1 && num_t->slot[0] == 1) || (big_int_compare(num_t, num_n_dec) == 0))
     {
         ret = 1;
         goto finish;
     }
-    big_int_dec(num_s);
-    while (!((num_s->slot_length == 1) && (num_s->slot[0] == 0)))
+    s = num_s_in->slot[0];
+    if (s < 2) goto finish;
+
+    /* t, n - 1 and the s - 1 squarings of t in the working domain,
+     * where both have one representative in [0, n) */
+    if (__big_int_powm_ctx_init(&ctx, num_n) != 0) goto finish;
+    ctx_ready = 1;
+    if ((num_minus_one = big_int_new_from_int(0)) == NULL) goto finish;
+    if (__big_int_powm_enter(&ctx, num_minus_one, num_n_dec) != 0) goto finish;
+    if (__big_int_powm_enter(&ctx, num_t, num_t) != 0) goto finish;
+    for (i = 1; i != s; i++)
     {
-        big_int_dec(num_s);
-        if (big_int_compare(num_t, num_n_dec) == 0)
+        if (__big_int_powm_sqr(&ctx, num_t, num_t) != 0) goto finish;
+        if (big_int_compare(num_t, num_minus_one) == 0)
         {
             ret = 1;
             goto finish;
         }
-        big_int_mul_to(num_t, num_t);
-        big_int_mod_to_with_barret(num_t, num_n, num_n_barret);
     }
-    if (big_int_compare(num_t, num_n_dec) == 0) ret = 1;
-    else ret = 0;
 finish:
-    if (num_t) big_int_destroy(num_t);
-    if (num_s) big_int_destroy(num_s);
+    if (ctx_ready) __big_int_powm_ctx_uninit(&ctx);
+    if (num_t != NULL) big_int_destroy(num_t);
+    if (num_minus_one != NULL) big_int_destroy(num_minus_one);
     return ret;
 }
 
@@ -416,7 +409,7 @@ int miller_rabin(big_int_t *num_n, int bit_length)
     int ret;
 	int loop;
     big_int_t *num_d = NULL, *num_s = NULL, *num_a = NULL;
-    big_int_t *num_n_dec, *num_n_barret = NULL;
+    big_int_t *num_n_dec;
 
     num_d = big_int_assign(num_n);
     big_int_dec(num_d);
@@ -430,28 +423,29 @@ int miller_rabin(big_int_t *num_n, int bit_length)
 
     loop = MILLER_RABIN_TEST_LOOP;
     ret = 1;
-    /* build barret for n */
-    num_n_barret = big_int_barret_build(num_n);
     while (loop-- > 0)
     {
-        num_a = big_int_new_random(MAX(bit_length >> 1, 16));
+        /* base 2 first, its powers are doublings and most composites
+         * fail it */
+        if (loop == MILLER_RABIN_TEST_LOOP - 1) num_a = big_int_new_from_int(2);
+        else num_a = big_int_new_random(MAX(bit_length >> 1, 16));
         while ((num_a->slot[0] == 0 && num_a->slot_length == 1) || (big_int_compare(num_a, num_n) >= 0))
         {
             big_int_destroy(num_a);
             num_a = big_int_new_random(MAX(bit_length, 16));
         }
 
-        if (miller_rabin_pass(num_a, num_s, num_d, num_n, num_n_dec, num_n_barret) != 1)
+        if (miller_rabin_pass(num_a, num_s, num_d, num_n, num_n_dec, NULL) != 1)
         {
             ret = 0;
             break;
         }
+        big_int_destroy(num_a); num_a = NULL;
     }
     if (num_a != NULL) big_int_destroy(num_a);
     if (num_s != NULL) big_int_destroy(num_s);
     if (num_d != NULL) big_int_destroy(num_d);
     if (num_n_dec != NULL) big_int_destroy(num_n_dec);
-    if (num_n_barret) big_int_destroy(num_n_barret);
     return ret;
 }
 
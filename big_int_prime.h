@@ -35,6 +35,7 @@
 big_int_t *big_int_new_prime(size_t bit_length);
 
 /* Prime number testing */
+int prime_divide_test(big_int_t *num); /* 1 if a small prime divides num */
 int fermat(big_int_t *num, int a);
 int miller_rabin_pass(big_int_t *num_a, big_int_t *num_s_in, big_int_t *num_d, big_int_t *num_n, big_int_t *num_n_dec, big_int_t *num_n_barret);
 int miller_rabin(big_int_t *num_n, int bit_length);
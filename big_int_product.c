@@ -0,0 +1,257 @@
+/*
+   Big Integer Library - Product Trees
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_product.h"
+
+#define BIT_PER_SLOT (32)
+
+/* Product trees
+ *
+ * Multiplying a list from left to right makes every step a long
+ * number times a short one, which stays on the schoolbook path.
+ * Pairing neighbours instead gives a balanced binary tree, the
+ * operands at each level have about the same size and the Karatsuba
+ * tier takes over as they grow. With a worker pool the list is cut
+ * into one contiguous range per subtree, then each level of the
+ * remaining top multiplies its pairs side by side. */
+
+/* words multiplied slot by slot into one int at the leaves */
+#define BIG_INT_PROD_WORDS_LEAF 16
+
+/* subtrees per thread */
+#define BIG_INT_PROD_SUBTREES_PER_THREAD 2
+
+static big_int_t *__big_int_prod_words_tree(const uint32_t *words, size_t n)
+{
+    size_t i, j;
+    uint64_t carry;
+    big_int_t *left, *right;
+
+    if (n <= BIG_INT_PROD_WORDS_LEAF)
+    {
+        if ((left = big_int_new_from_int(1)) == NULL) return NULL;
+        if (__big_int_reserve(left, n + 1) != 0) { big_int_destroy(left); return NULL; }
+        for (i = 0; i != n; i++)
+        {
+            carry = 0;
+            for (j = 0; j != left->slot_length; j++)
+            {
+                carry += (uint64_t)left->slot[j] * words[i];
+                left->slot[j] = (slot_t)carry;
+                carry >>= BIT_PER_SLOT;
+            }
+            if (carry != 0) left->slot[left->slot_length++] = (slot_t)carry;
+        }
+        __big_int_normalize(left);
+        return left;
+    }
+    if ((left = __big_int_prod_words_tree(words, n / 2)) == NULL) return NULL;
+    if ((right = __big_int_prod_words_tree(words + n / 2, n - n / 2)) == NULL) { big_int_destroy(left); return NULL; }
+    if (big_int_mul_to(left, right) != 0) { big_int_destroy(left); left = NULL; }
+    big_int_destroy(right);
+    return left;
+}
+
+static big_int_t *__big_int_prod_values_tree(big_int_t **values, size_t n)
+{
+    big_int_t *left, *right;
+
+    if (n == 0) return big_int_new_from_int(1);
+    if (n == 1) return big_int_assign(values[0]);
+    if ((left = __big_int_prod_values_tree(values, n / 2)) == NULL) return NULL;
+    if ((right = __big_int_prod_values_tree(values + n / 2, n - n / 2)) == NULL) { big_int_destroy(left); return NULL; }
+    if (big_int_mul_to(left, right) != 0) { big_int_destroy(left); left = NULL; }
+    big_int_destroy(right);
+    return left;
+}
+
+/* one of values and words is set */
+typedef struct
+{
+    big_int_t **values;
+    const uint32_t *words;
+    size_t n;
+    size_t count; /* subtrees, then pairs of the level */
+    big_int_t **partial;
+    int *status; /* one per job, read after the run */
+} big_int_prod_job_t;
+
+static void __big_int_prod_subtree_job(void *arg, size_t idx)
+{
+    big_int_prod_job_t *job = (big_int_prod_job_t *)arg;
+    size_t from = job->n * idx / job->count, to = job->n * (idx + 1) / job->count;
+
+    if (job->values != NULL)
+        job->partial[idx] = __big_int_prod_values_tree(job->values + from, to - from);
+    else
+        job->partial[idx] = __big_int_prod_words_tree(job->words + from, to - from);
+    job->status[idx] = (job->partial[idx] == NULL) ? -1 : 0;
+}
+
+/* each job owns its pair */
+static void __big_int_prod_pair_job(void *arg, size_t idx)
+{
+    big_int_prod_job_t *job = (big_int_prod_job_t *)arg;
+
+    job->status[idx] = big_int_mul_to(job->partial[2 * idx], job->partial[2 * idx + 1]);
+}
+
+static big_int_t *__big_int_prod_parallel(big_int_prod_job_t *job, big_int_worker_pool_t *pool)
+{
+    size_t idx, subtrees, pairs;
+    int failed = 0;
+    big_int_t *result = NULL;
+
+    subtrees = (big_int_worker_pool_threads(pool) + 1) * BIG_INT_PROD_SUBTREES_PER_THREAD;
+    if (subtrees > job->n) subtrees = job->n;
+    if ((job->partial = (big_int_t **)malloc(sizeof(big_int_t *) * subtrees)) == NULL) return NULL;
+    if ((job->status = (int *)malloc(sizeof(int) * subtrees)) == NULL)
+    {
+        free(job->partial);
+        return NULL;
+    }
+    for (idx = 0; idx != subtrees; idx++)
+    {
+        job->partial[idx] = NULL;
+        job->status[idx] = -1;
+    }
+    job->count = subtrees;
+    if (big_int_worker_pool_run(pool, __big_int_prod_subtree_job, job, subtrees) != 0) failed = 1;
+    for (idx = 0; idx != subtrees; idx++)
+    {
+        if (job->status[idx] != 0) failed = 1;
+    }
+
+    while ((failed == 0) && (subtrees > 1))
+    {
+        pairs = subtrees / 2;
+        for (idx = 0; idx != pairs; idx++) job->status[idx] = -1;
+        if (big_int_worker_pool_run(pool, __big_int_prod_pair_job, job, pairs) != 0) failed = 1;
+        for (idx = 0; idx != pairs; idx++)
+        {
+            if (job->status[idx] != 0) failed = 1;
+        }
+        for (idx = 0; idx != pairs; idx++)
+        {
+            big_int_destroy(job->partial[2 * idx + 1]);
+            job->partial[idx] = job->partial[2 * idx];
+        }
+        /* the odd one out moves up as it is */
+        if ((subtrees & 1) != 0) job->partial[pairs] = job->partial[subtrees - 1];
+        for (idx = (subtrees + 1) / 2; idx != subtrees; idx++) job->partial[idx] = NULL;
+        subtrees = (subtrees + 1) / 2;
+    }
+    if (failed == 0)
+    {
+        result = job->partial[0];
+        job->partial[0] = NULL;
+    }
+    for (idx = 0; idx != subtrees; idx++)
+    {
+        if (job->partial[idx] != NULL) big_int_destroy(job->partial[idx]);
+    }
+    free(job->partial);
+    free(job->status);
+    return result;
+}
+
+/* worth the threads */
+static int __big_int_prod_use_pool(big_int_worker_pool_t *pool, size_t n)
+{
+    return (pool != NULL) && (big_int_worker_pool_threads(pool) != 0) && \
+        (n >= 2 * (big_int_worker_pool_threads(pool) + 1) * BIG_INT_PROD_SUBTREES_PER_THREAD);
+}
+
+big_int_t *__big_int_prod_words(const uint32_t *words, size_t n, big_int_worker_pool_t *pool)
+{
+    big_int_prod_job_t job;
+
+    if (!__big_int_prod_use_pool(pool, n / BIG_INT_PROD_WORDS_LEAF)) return __big_int_prod_words_tree(words, n);
+    job.values = NULL;
+    job.words = words;
+    job.n = n;
+    return __big_int_prod_parallel(&job, pool);
+}
+
+int big_int_prod(big_int_t *r, big_int_t **values, size_t n, big_int_worker_pool_t *pool)
+{
+    big_int_t *result;
+    big_int_prod_job_t job;
+
+    if (!__big_int_prod_use_pool(pool, n))
+    {
+        result = __big_int_prod_values_tree(values, n);
+    }
+    else
+    {
+        job.values = values;
+        job.words = NULL;
+        job.n = n;
+        result = __big_int_prod_parallel(&job, pool);
+    }
+    if (result == NULL) return -1;
+    __big_int_move_to(r, result);
+    return 0;
+}
+
+int big_int_primorial(big_int_t *r, unsigned int n, big_int_worker_pool_t *pool)
+{
+    int ret = -1;
+    size_t i, j, count = 0;
+    uint64_t acc = 1;
+    uint32_t *words = NULL;
+    char *composite = NULL;
+    big_int_t *result;
+
+    if ((composite = (char *)calloc((size_t)n + 1, 1)) == NULL) return -1;
+    /* the primes packed into words, at most one word per prime */
+    if ((words = (uint32_t *)malloc(sizeof(uint32_t) * ((size_t)n / 2 + 2))) == NULL) goto fail;
+    if (n >= 2) acc = 2;
+    for (i = 3; i <= n; i += 2)
+    {
+        if (composite[i]) continue;
+        for (j = i * i; j <= n; j += 2 * i) composite[j] = 1;
+        if (acc * i > 0xFFFFFFFF)
+        {
+            words[count++] = (uint32_t)acc;
+            acc = 1;
+        }
+        acc *= i;
+    }
+    words[count++] = (uint32_t)acc;
+    if ((result = __big_int_prod_words(words, count, pool)) == NULL) goto fail;
+    __big_int_move_to(r, result);
+    ret = 0;
+fail:
+    free(composite);
+    if (words != NULL) free(words);
+    return ret;
+}
@@ -0,0 +1,46 @@
+/*
+   Big Integer Library - Product Trees
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_PRODUCT_H_
+#define _BIG_INT_PRODUCT_H_
+
+#include "big_int.h"
+#include "big_int_worker_pool.h"
+
+/* r = values[0] * ... * values[n - 1], 1 for n = 0,
+ * the subtrees run on the threads of pool when it is not NULL */
+int big_int_prod(big_int_t *r, big_int_t **values, size_t n, big_int_worker_pool_t *pool);
+
+/* r = product of the primes <= n */
+int big_int_primorial(big_int_t *r, unsigned int n, big_int_worker_pool_t *pool);
+
+/* internal use only */
+/* product of words[0..n-1] */
+big_int_t *__big_int_prod_words(const uint32_t *words, size_t n, big_int_worker_pool_t *pool);
+
+#endif
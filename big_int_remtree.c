@@ -0,0 +1,380 @@
+/*
+   Big Integer Library - Remainder Trees
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_gcd.h"
+#include "big_int_remtree.h"
+
+/* Remainder trees
+ *
+ * Reducing one number modulo n moduli one by one costs n full
+ * divisions of a long number. The product tree of the moduli turns
+ * this around: x is reduced modulo the root once, then every node
+ * reduces the remainder of its parent modulo its own product, so
+ * each level works on numbers about as long as its moduli.
+ *
+ * Batch gcd (Bernstein) descends the same tree from the root P with
+ * the squares of the nodes, the leaves end up with P mod N_i^2, and
+ * gcd(N_i, (P mod N_i^2) / N_i) is the common part of N_i with the
+ * other moduli.
+ *
+ * Every level has about the size of all the moduli together. Both
+ * passes only walk a level from left to right, so a level that would
+ * exceed the memory budget goes to a temporary file and is read back
+ * one node at a time. */
+
+/* enough levels for any size_t count */
+#define BIG_INT_REMTREE_MAX_DEPTH (sizeof(size_t) * 8 + 1)
+
+typedef struct
+{
+    size_t count;
+    size_t bytes;
+    size_t cursor;
+    big_int_t **nodes; /* NULL when the level is in file */
+    FILE *fp;
+    int borrowed; /* nodes belong to the caller */
+} big_int_remtree_level_t;
+
+static int __big_int_remtree_level_init(big_int_remtree_level_t *level, size_t count, int on_disk)
+{
+    level->count = count;
+    level->bytes = 0;
+    level->cursor = 0;
+    level->nodes = NULL;
+    level->fp = NULL;
+    level->borrowed = 0;
+    if (on_disk != 0)
+    {
+        if ((level->fp = tmpfile()) == NULL) return -1;
+    }
+    else
+    {
+        if ((level->nodes = (big_int_t **)calloc(count, sizeof(big_int_t *))) == NULL) return -1;
+    }
+    return 0;
+}
+
+static void __big_int_remtree_level_release(big_int_remtree_level_t *level)
+{
+    size_t i;
+
+    if (level->nodes != NULL && level->borrowed == 0)
+    {
+        for (i = 0; i != level->count; i++)
+        {
+            if (level->nodes[i] != NULL) big_int_destroy(level->nodes[i]);
+        }
+        free(level->nodes);
+    }
+    if (level->fp != NULL) fclose(level->fp);
+    level->nodes = NULL;
+    level->fp = NULL;
+}
+
+static int __big_int_remtree_level_rewind(big_int_remtree_level_t *level)
+{
+    level->cursor = 0;
+    if (level->fp != NULL)
+    {
+        if (fflush(level->fp) != 0) return -1;
+        rewind(level->fp);
+    }
+    return 0;
+}
+
+/* takes over 'num' */
+static int __big_int_remtree_level_append(big_int_remtree_level_t *level, big_int_t *num)
+{
+    level->bytes += num->slot_length * sizeof(slot_t);
+    if (level->fp == NULL)
+    {
+        level->nodes[level->cursor++] = num;
+        return 0;
+    }
+    level->cursor++;
+    if (fwrite(&num->slot_length, sizeof(size_t), 1, level->fp) != 1) goto fail;
+    if (fwrite(&num->sign, sizeof(int), 1, level->fp) != 1) goto fail;
+    if (fwrite(num->slot, sizeof(slot_t), num->slot_length, level->fp) != num->slot_length) goto fail;
+    big_int_destroy(num);
+    return 0;
+fail:
+    big_int_destroy(num);
+    return -1;
+}
+
+/* next node from left to right, '*owned' tells whether the caller
+ * has to destroy it */
+static big_int_t *__big_int_remtree_level_next(big_int_remtree_level_t *level, int *owned)
+{
+    big_int_t *num;
+    size_t slot_length;
+    int sign;
+
+    *owned = 0;
+    if (level->fp == NULL) return level->nodes[level->cursor++];
+    level->cursor++;
+    if (fread(&slot_length, sizeof(size_t), 1, level->fp) != 1) return NULL;
+    if (fread(&sign, sizeof(int), 1, level->fp) != 1) return NULL;
+    if (slot_length == 0) return NULL;
+    if ((num = big_int_new_from_int(0)) == NULL) return NULL;
+    if (__big_int_reserve(num, slot_length) != 0) goto fail;
+    if (fread(num->slot, sizeof(slot_t), slot_length, level->fp) != slot_length) goto fail;
+    num->slot_length = slot_length;
+    num->sign = sign;
+    __big_int_normalize(num);
+    *owned = 1;
+    return num;
+fail:
+    big_int_destroy(num);
+    return NULL;
+}
+
+/* levels[0] borrows the moduli, levels[*depth - 1] holds the root */
+static int __big_int_remtree_build(big_int_remtree_level_t *levels, size_t *depth, \
+        big_int_t **moduli, size_t n, size_t memory_limit, size_t *memory)
+{
+    big_int_remtree_level_t *lower, *upper;
+    big_int_t *a = NULL, *b = NULL, *p;
+    int own_a = 0, own_b = 0;
+    size_t i;
+
+    levels[0].count = n;
+    levels[0].bytes = 0;
+    levels[0].cursor = 0;
+    levels[0].nodes = moduli;
+    levels[0].fp = NULL;
+    levels[0].borrowed = 1;
+    for (i = 0; i != n; i++) levels[0].bytes += moduli[i]->slot_length * sizeof(slot_t);
+    *depth = 1;
+    *memory = 0;
+
+    while (levels[*depth - 1].count > 1)
+    {
+        lower = &levels[*depth - 1];
+        upper = &levels[*depth];
+        if (__big_int_remtree_level_init(upper, (lower->count + 1) / 2, \
+                    memory_limit != 0 && *memory + lower->bytes > memory_limit) != 0) return -1;
+        (*depth)++;
+        if (__big_int_remtree_level_rewind(lower) != 0) return -1;
+        for (i = 0; i != upper->count; i++)
+        {
+            if ((a = __big_int_remtree_level_next(lower, &own_a)) == NULL) goto fail;
+            if (2 * i + 1 < lower->count)
+            {
+                if ((b = __big_int_remtree_level_next(lower, &own_b)) == NULL) goto fail;
+                p = big_int_mul(a, b);
+            }
+            else
+            {
+                p = big_int_assign(a);
+            }
+            if (own_a != 0) big_int_destroy(a);
+            if (own_b != 0) big_int_destroy(b);
+            a = b = NULL;
+            own_a = own_b = 0;
+            if (p == NULL) return -1;
+            if (__big_int_remtree_level_append(upper, p) != 0) return -1;
+        }
+        if (upper->fp == NULL) *memory += upper->bytes;
+    }
+    return 0;
+fail:
+    if (own_a != 0 && a != NULL) big_int_destroy(a);
+    return -1;
+}
+
+/* out[i] = top mod node_i (node_i^2 when squared) along levels[0..depth-2] */
+static int __big_int_remtree_descend(big_int_t **out, big_int_remtree_level_t *levels, size_t depth, \
+        big_int_t *top, int squared, size_t memory_limit, size_t memory)
+{
+    big_int_remtree_level_t parent, child;
+    big_int_t *r = NULL, *m = NULL, *m2 = NULL, *rem = NULL;
+    int own_r = 0, own_m = 0;
+    size_t k, i, j;
+    int ret = -1;
+
+    parent.nodes = NULL;
+    parent.fp = NULL;
+    child.nodes = NULL;
+    child.fp = NULL;
+    if (__big_int_remtree_level_init(&parent, 1, 0) != 0) return -1;
+    parent.nodes[0] = top;
+    parent.bytes = top->slot_length * sizeof(slot_t);
+
+    for (k = depth - 1; k-- != 0;)
+    {
+        if (k != 0)
+        {
+            if (__big_int_remtree_level_init(&child, levels[k].count, \
+                        memory_limit != 0 && \
+                        memory + (parent.fp == NULL ? parent.bytes : 0) + \
+                        (squared != 0 ? 2 : 1) * levels[k].bytes > memory_limit) != 0) goto fail;
+        }
+        if (__big_int_remtree_level_rewind(&parent) != 0) goto fail;
+        if (__big_int_remtree_level_rewind(&levels[k]) != 0) goto fail;
+        for (i = 0, j = 0; j != parent.count; j++)
+        {
+            if ((r = __big_int_remtree_level_next(&parent, &own_r)) == NULL) goto fail;
+            for (; i != levels[k].count && i < 2 * j + 2; i++)
+            {
+                if ((m = __big_int_remtree_level_next(&levels[k], &own_m)) == NULL) goto fail;
+                if (squared != 0)
+                {
+                    if ((m2 = big_int_mul(m, m)) == NULL) goto fail;
+                }
+                if ((rem = big_int_new_from_int(0)) == NULL) goto fail;
+                if (big_int_divrem_floor(NULL, rem, r, squared != 0 ? m2 : m) != 0) goto fail;
+                if (m2 != NULL) { big_int_destroy(m2); m2 = NULL; }
+                if (own_m != 0) big_int_destroy(m);
+                m = NULL;
+                own_m = 0;
+                if (k == 0)
+                {
+                    __big_int_move_to(out[i], rem);
+                    rem = NULL;
+                }
+                else
+                {
+                    if (__big_int_remtree_level_append(&child, rem) != 0) { rem = NULL; goto fail; }
+                    rem = NULL;
+                }
+            }
+            if (own_r != 0) big_int_destroy(r);
+            r = NULL;
+            own_r = 0;
+        }
+        /* the top belongs to the caller */
+        if (parent.count == 1 && parent.nodes != NULL && parent.nodes[0] == top) parent.nodes[0] = NULL;
+        __big_int_remtree_level_release(&parent);
+        parent = child;
+        child.nodes = NULL;
+        child.fp = NULL;
+    }
+
+    ret = 0;
+fail:
+    if (own_r != 0 && r != NULL) big_int_destroy(r);
+    if (own_m != 0 && m != NULL) big_int_destroy(m);
+    if (m2 != NULL) big_int_destroy(m2);
+    if (rem != NULL) big_int_destroy(rem);
+    if (parent.nodes != NULL && parent.nodes[0] == top) parent.nodes[0] = NULL;
+    __big_int_remtree_level_release(&parent);
+    __big_int_remtree_level_release(&child);
+    return ret;
+}
+
+static int __big_int_remtree_check(big_int_t **moduli, size_t n)
+{
+    size_t i;
+
+    for (i = 0; i != n; i++)
+    {
+        if (moduli[i]->sign == BIG_NUMBER_NEGATIVE) return -1;
+        if (moduli[i]->slot_length == 1 && moduli[i]->slot[0] == 0) return -1;
+    }
+    return 0;
+}
+
+int big_int_mod_multi(big_int_t **residues, big_int_t *x, \
+        big_int_t **moduli, size_t n, size_t memory_limit)
+{
+    big_int_remtree_level_t levels[BIG_INT_REMTREE_MAX_DEPTH];
+    big_int_t *root = NULL, *top = NULL;
+    int own_root = 0;
+    size_t depth = 0, memory, k;
+    int ret = -1;
+
+    if (n == 0) return 0;
+    if (__big_int_remtree_check(moduli, n) != 0) return -1;
+
+    if (__big_int_remtree_build(levels, &depth, moduli, n, memory_limit, &memory) != 0) goto fail;
+
+    if ((top = big_int_new_from_int(0)) == NULL) goto fail;
+    if (__big_int_remtree_level_rewind(&levels[depth - 1]) != 0) goto fail;
+    if ((root = __big_int_remtree_level_next(&levels[depth - 1], &own_root)) == NULL) goto fail;
+    if (big_int_divrem_floor(NULL, top, x, root) != 0) goto fail;
+    if (depth == 1)
+    {
+        if (big_int_assign_to(residues[0], top) != 0) goto fail;
+    }
+    else
+    {
+        if (__big_int_remtree_descend(residues, levels, depth, top, 0, memory_limit, memory) != 0) goto fail;
+    }
+
+    ret = 0;
+fail:
+    if (own_root != 0 && root != NULL) big_int_destroy(root);
+    if (top != NULL) big_int_destroy(top);
+    for (k = 0; k != depth; k++) __big_int_remtree_level_release(&levels[k]);
+    return ret;
+}
+
+int big_int_batch_gcd(big_int_t **gcds, big_int_t **moduli, size_t n, \
+        size_t memory_limit)
+{
+    big_int_remtree_level_t levels[BIG_INT_REMTREE_MAX_DEPTH];
+    big_int_t *top = NULL;
+    int own_top = 0;
+    size_t depth = 0, memory, i, k;
+    int ret = -1;
+
+    if (n == 0) return 0;
+    if (__big_int_remtree_check(moduli, n) != 0) return -1;
+
+    if (__big_int_remtree_build(levels, &depth, moduli, n, memory_limit, &memory) != 0) goto fail;
+
+    /* P mod P^2 = P */
+    if (__big_int_remtree_level_rewind(&levels[depth - 1]) != 0) goto fail;
+    if ((top = __big_int_remtree_level_next(&levels[depth - 1], &own_top)) == NULL) goto fail;
+    if (depth == 1)
+    {
+        if (big_int_assign_to(gcds[0], top) != 0) goto fail;
+    }
+    else
+    {
+        if (__big_int_remtree_descend(gcds, levels, depth, top, 1, memory_limit, memory) != 0) goto fail;
+    }
+
+    /* gcd(N_i, (P mod N_i^2) / N_i) */
+    for (i = 0; i != n; i++)
+    {
+        if (big_int_divexact(gcds[i], gcds[i], moduli[i]) != 0) goto fail;
+        if (big_int_gcd(gcds[i], moduli[i], gcds[i]) != 0) goto fail;
+    }
+
+    ret = 0;
+fail:
+    if (own_top != 0 && top != NULL) big_int_destroy(top);
+    for (k = 0; k != depth; k++) __big_int_remtree_level_release(&levels[k]);
+    return ret;
+}
@@ -0,0 +1,47 @@
+/*
+   Big Integer Library - Remainder Trees
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_REMTREE_H_
+#define _BIG_INT_REMTREE_H_
+
+#include "big_int.h"
+
+/* Both functions build the product tree of moduli, the levels
+ * beyond memory_limit bytes are kept in temporary files and read
+ * back one node at a time, 0 keeps every level in memory */
+
+/* residues[i] = x mod moduli[i], moduli must be positive */
+int big_int_mod_multi(big_int_t **residues, big_int_t *x, \
+        big_int_t **moduli, size_t n, size_t memory_limit);
+
+/* gcds[i] = gcd(moduli[i], product of the other moduli),
+ * moduli must be positive */
+int big_int_batch_gcd(big_int_t **gcds, big_int_t **moduli, size_t n, \
+        size_t memory_limit);
+
+#endif
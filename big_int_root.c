@@ -0,0 +1,507 @@
+/*
+   Big Integer Library - Integer Roots
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_root.h"
+
+#define BIT_PER_SLOT (32)
+
+/* Roots by Newton iteration with doubling precision
+ *
+ * The root of n comes from the root of its top part n >> (k * h),
+ * shifted back by h bits, which is off by about 2^h. A single step
+ * x' = ((k - 1) * x + n / x^(k-1)) / k squares the relative error,
+ * so h is kept a few bits below half the root length and x' ends
+ * within a unit of floor(n^(1/k)), never below it. The sizes halve
+ * on the way down, the whole costs about one division at full size
+ * plus the x^k checking the last unit. */
+
+/* bits kept over k in the error bound of a step */
+#define BIG_INT_ROOT_GUARD_BITS 6
+
+static size_t __big_int_root_bit_length(uint64_t value)
+{
+    size_t bits = 0;
+
+    while (value != 0) { value >>= 1; bits++; }
+    return bits;
+}
+
+static uint64_t __big_int_root_u64_of(big_int_t *num)
+{
+    return (num->slot_length > 1) ? (((uint64_t)num->slot[1] << BIT_PER_SLOT) | num->slot[0]) : num->slot[0];
+}
+
+static big_int_t *__big_int_root_new_u64(uint64_t value)
+{
+    big_int_t *num;
+
+    if ((num = big_int_new_from_int((unsigned int)value)) == NULL) return NULL;
+    if ((value >> BIT_PER_SLOT) != 0)
+    {
+        if (__big_int_reserve(num, 2) != 0) { big_int_destroy(num); return NULL; }
+        num->slot[1] = (slot_t)(value >> BIT_PER_SLOT);
+        num->slot_length = 2;
+        __big_int_normalize(num);
+    }
+    return num;
+}
+
+/* c^k <= n */
+static int __big_int_root_u64_fits(uint64_t c, unsigned int k, uint64_t n)
+{
+    uint64_t p = 1;
+
+    while (k-- != 0)
+    {
+        if (p > n / c) return 0;
+        p *= c;
+    }
+    return 1;
+}
+
+/* floor(n^(1/k)), 2 <= k < bits of n */
+static uint64_t __big_int_root_u64(uint64_t n, unsigned int k)
+{
+    size_t root_bits = (__big_int_root_bit_length(n) + k - 1) / k;
+    uint64_t x, y, bit;
+
+    if (k == 2)
+    {
+        /* from above, decreasing until floor(sqrt(n)) */
+        x = (uint64_t)1 << root_bits;
+        while ((y = (x + n / x) >> 1) < x) x = y;
+        return x;
+    }
+    x = 0;
+    for (bit = (uint64_t)1 << (root_bits - 1); bit != 0; bit >>= 1)
+    {
+        if (__big_int_root_u64_fits(x | bit, k, n)) x |= bit;
+    }
+    return x;
+}
+
+/* floor(n^(1/k)) for a root of root_bits <= 64, bit by bit */
+static big_int_t *__big_int_root_bisect(big_int_t *n, unsigned int k, size_t root_bits)
+{
+    uint64_t x = 0, bit;
+    big_int_t *c = NULL, *power = NULL;
+
+    if ((power = big_int_new_from_int(k)) == NULL) return NULL;
+    for (bit = (uint64_t)1 << (root_bits - 1); bit != 0; bit >>= 1)
+    {
+        if ((c = __big_int_root_new_u64(x | bit)) == NULL) goto fail;
+        if (big_int_pow_to(c, power) != 0) goto fail;
+        if (big_int_compare(c, n) <= 0) x |= bit;
+        big_int_destroy(c); c = NULL;
+    }
+    big_int_destroy(power);
+    return __big_int_root_new_u64(x);
+fail:
+    if (c != NULL) big_int_destroy(c);
+    big_int_destroy(power);
+    return NULL;
+}
+
+/* x = ((k - 1) * x + n / x^(k-1)) / k */
+static int __big_int_root_newton(big_int_t *x, big_int_t *n, unsigned int k)
+{
+    int ret = -1;
+    big_int_t *t = NULL, *power = NULL;
+
+    if (k == 2)
+    {
+        if ((t = big_int_new_from_int(0)) == NULL) return -1;
+        if (big_int_divrem(t, NULL, n, x) != 0) goto fail;
+        if (big_int_add_to(x, t) != 0) goto fail;
+        if (big_int_right_shift(x, 1) != 0) goto fail;
+    }
+    else
+    {
+        if ((power = big_int_new_from_int(k - 1)) == NULL) return -1;
+        if ((t = big_int_assign(x)) == NULL) goto fail;
+        if (big_int_pow_to(t, power) != 0) goto fail;
+        if (big_int_divrem(t, NULL, n, t) != 0) goto fail;
+        if (big_int_mul_to(x, power) != 0) goto fail;
+        if (big_int_add_to(x, t) != 0) goto fail;
+        __big_int_slots_divrem_1(x->slot, x->slot, x->slot_length, (slot_t)k);
+        __big_int_normalize(x);
+    }
+    ret = 0;
+fail:
+    if (t != NULL) big_int_destroy(t);
+    if (power != NULL) big_int_destroy(power);
+    return ret;
+}
+
+/* Square roots run the same steps on bare slots with one scratch
+ * buffer, there is no int to allocate per step */
+
+static size_t __big_int_root_slots_length(const slot_t *a, size_t n)
+{
+    while ((n > 1) && (a[n - 1] == 0)) n--;
+    return n;
+}
+
+/* r = a >> bits, r could be a, returns the length */
+static size_t __big_int_root_slots_rshift(slot_t *r, const slot_t *a, size_t n, size_t bits)
+{
+    size_t i, skip = bits / BIT_PER_SLOT, shift = bits % BIT_PER_SLOT;
+
+    for (i = 0; i + skip < n; i++)
+    {
+        r[i] = a[i + skip] >> shift;
+        if ((shift != 0) && (i + skip + 1 < n)) r[i] |= a[i + skip + 1] << (BIT_PER_SLOT - shift);
+    }
+    return __big_int_root_slots_length(r, n - skip);
+}
+
+/* r = a << bits, r could be a, returns the length */
+static size_t __big_int_root_slots_lshift(slot_t *r, const slot_t *a, size_t n, size_t bits)
+{
+    size_t i, skip = bits / BIT_PER_SLOT, shift = bits % BIT_PER_SLOT;
+
+    r[n + skip] = (shift != 0) ? a[n - 1] >> (BIT_PER_SLOT - shift) : 0;
+    for (i = n; i-- != 0;)
+    {
+        r[i + skip] = a[i] << shift;
+        if ((shift != 0) && (i != 0)) r[i + skip] |= a[i - 1] >> (BIT_PER_SLOT - shift);
+    }
+    for (i = 0; i != skip; i++) r[i] = 0;
+    return __big_int_root_slots_length(r, n + skip + 1);
+}
+
+/* x = floor(sqrt(n)) or a unit above, n[0..nl-1] normalized and not zero,
+ * x takes nl / 2 + 3 slots, scratch takes 4 * nl + 16 slots */
+static size_t __big_int_root_slots_sqrt(slot_t *x, const slot_t *n, size_t nl, slot_t *scratch)
+{
+    size_t i, bits, h, xl, ql, ml;
+    uint64_t value, carry;
+    slot_t *q, *un, *vn;
+
+    bits = (size_t)BIT_PER_SLOT * (nl - 1) + __big_int_root_bit_length(n[nl - 1]);
+    if (bits <= 64)
+    {
+        value = __big_int_root_u64((nl > 1) ? (((uint64_t)n[1] << BIT_PER_SLOT) | n[0]) : n[0], 2);
+        x[0] = (slot_t)value;
+        x[1] = (slot_t)(value >> BIT_PER_SLOT);
+        return (x[1] != 0) ? 2 : 1;
+    }
+    h = ((bits + 1) / 2 - 2 - BIG_INT_ROOT_GUARD_BITS) / 2;
+    ml = __big_int_root_slots_rshift(scratch, n, nl, 2 * h);
+    xl = __big_int_root_slots_sqrt(x, scratch, ml, scratch + ml);
+    xl = __big_int_root_slots_lshift(x, x, xl, h);
+
+    /* x = (x + n / x) / 2 */
+    q = scratch; un = q + nl + 1; vn = un + nl + 1;
+    if (xl == 1)
+    {
+        __big_int_slots_divrem_1(q, n, nl, x[0]);
+        ql = nl;
+    }
+    else
+    {
+        __big_int_slots_divrem(q, NULL, n, nl, x, xl, un, vn);
+        ql = nl - xl + 1;
+    }
+    ql = __big_int_root_slots_length(q, ql);
+    for (i = xl; i < ql; i++) x[i] = 0;
+    xl = (ql > xl) ? ql : xl;
+    carry = 0;
+    for (i = 0; i != xl; i++)
+    {
+        carry += (uint64_t)x[i] + ((i < ql) ? q[i] : 0);
+        x[i] = (slot_t)carry;
+        carry >>= BIT_PER_SLOT;
+    }
+    x[xl++] = (slot_t)carry;
+    return __big_int_root_slots_rshift(x, x, xl, 1);
+}
+
+/* x with floor(n^(1/k)) <= x <= floor(n^(1/k)) + 1, n > 0, k >= 2 */
+static big_int_t *__big_int_root_approx(big_int_t *n, unsigned int k)
+{
+    size_t root_bits, guard, h;
+    big_int_t *m = NULL, *x = NULL;
+
+    if (k >= n->bit_length) return big_int_new_from_int(1);
+    if (n->bit_length <= 64) return __big_int_root_new_u64(__big_int_root_u64(__big_int_root_u64_of(n), k));
+    root_bits = (n->bit_length + k - 1) / k;
+    guard = __big_int_root_bit_length(k) + BIG_INT_ROOT_GUARD_BITS;
+    /* too short to halve */
+    if ((root_bits <= 2 * guard) && (root_bits <= 64)) return __big_int_root_bisect(n, k, root_bits);
+
+    h = (root_bits - guard) / 2;
+    if ((m = big_int_assign(n)) == NULL) return NULL;
+    if (big_int_right_shift(m, (int)(k * h)) != 0) goto fail;
+    if ((x = __big_int_root_approx(m, k)) == NULL) goto fail;
+    if (big_int_left_shift(x, (int)h) != 0) goto fail;
+    if (__big_int_root_newton(x, n, k) != 0) goto fail;
+    big_int_destroy(m);
+    return x;
+fail:
+    if (m != NULL) big_int_destroy(m);
+    if (x != NULL) big_int_destroy(x);
+    return NULL;
+}
+
+int big_int_rootrem(big_int_t *r, big_int_t *rem, big_int_t *n, unsigned int k)
+{
+    int ret = -1;
+    int sign = n->sign;
+    big_int_t *a = NULL, *x = NULL, *t = NULL, *power = NULL;
+    slot_t *scratch = NULL;
+
+    if ((k == 0) || ((sign == BIG_NUMBER_NEGATIVE) && ((k & 1) == 0))) return -1;
+    if ((a = big_int_assign(n)) == NULL) return -1;
+    a->sign = BIG_NUMBER_POSITIVE;
+    if ((k == 1) || (big_int_is_zero(a)))
+    {
+        if ((x = big_int_assign(a)) == NULL) goto fail;
+        if ((t = big_int_new_from_int(0)) == NULL) goto fail;
+    }
+    else if (k == 2)
+    {
+        if ((x = big_int_new_from_int(0)) == NULL) goto fail;
+        if (__big_int_reserve(x, a->slot_length / 2 + 3) != 0) goto fail;
+        if ((scratch = (slot_t *)malloc(sizeof(slot_t) * (4 * a->slot_length + 16))) == NULL) goto fail;
+        x->slot_length = __big_int_root_slots_sqrt(x->slot, a->slot, a->slot_length, scratch);
+        __big_int_normalize(x);
+    }
+    if (t == NULL)
+    {
+        if ((x == NULL) && ((x = __big_int_root_approx(a, k)) == NULL)) goto fail;
+        if ((power = big_int_new_from_int(k)) == NULL) goto fail;
+        /* t = a - x^k, x is a unit or so too large at most */
+        for (;;)
+        {
+            if ((t = big_int_assign(x)) == NULL) goto fail;
+            if (big_int_pow_to(t, power) != 0) goto fail;
+            t->sign = BIG_NUMBER_NEGATIVE;
+            if (big_int_add_to(t, a) != 0) goto fail;
+            if (t->sign == BIG_NUMBER_POSITIVE) break;
+            if (k == 2) break;
+            if (big_int_dec(x) != 0) goto fail;
+            big_int_destroy(t); t = NULL;
+        }
+        /* a - (x - 1)^2 = a - x^2 + 2x - 1 */
+        while (t->sign == BIG_NUMBER_NEGATIVE)
+        {
+            if (big_int_add_to(t, x) != 0) goto fail;
+            if (big_int_dec(x) != 0) goto fail;
+            if (big_int_add_to(t, x) != 0) goto fail;
+        }
+    }
+    /* -(x^k) for the odd roots of negative n */
+    if (!big_int_is_zero(x)) x->sign = sign;
+    if (!big_int_is_zero(t)) t->sign = sign;
+    if (rem != NULL) { __big_int_move_to(rem, t); t = NULL; }
+    __big_int_move_to(r, x); x = NULL;
+    ret = 0;
+fail:
+    big_int_destroy(a);
+    if (x != NULL) big_int_destroy(x);
+    if (t != NULL) big_int_destroy(t);
+    if (power != NULL) big_int_destroy(power);
+    if (scratch != NULL) free(scratch);
+    return ret;
+}
+
+int big_int_root(big_int_t *r, big_int_t *n, unsigned int k)
+{
+    return big_int_rootrem(r, NULL, n, k);
+}
+
+int big_int_sqrtrem(big_int_t *s, big_int_t *r, big_int_t *n)
+{
+    return big_int_rootrem(s, r, n, 2);
+}
+
+/* Perfect powers
+ *
+ * A square stays a square modulo anything: the low slot gives n mod 64
+ * and one single slot division n mod 45045 = 63 * 65 * 11, the residue
+ * tables let 12/64 * 16/63 * 21/65 * 6/11 of the non-squares through,
+ * under 1%, before a root is taken. An odd prime power n = a^p is
+ * likewise a p-th power modulo each prime q = 1 mod p, which holds
+ * for only 1/p of the residues, so a few such q sort out most
+ * exponents with one pass over the slots each. */
+
+#define BIG_INT_ROOT_SQUARE_MOD (63 * 65 * 11)
+#define BIG_INT_ROOT_POWER_MODS 4
+#define BIG_INT_ROOT_POWER_GROUP 8
+
+/* bit r set when r is a square modulo 64, 63, 65 and 11 */
+static const uint32_t big_int_root_square_64[] = { 0x02030213, 0x02020212 };
+static const uint32_t big_int_root_square_63[] = { 0x12450293, 0x04024830 };
+static const uint32_t big_int_root_square_65[] = { 0x66014613, 0x218A0198, 0x00000001 };
+static const uint32_t big_int_root_square_11[] = { 0x0000023B };
+
+#define BIG_INT_ROOT_TABLE_HAS(table, r) (((table)[(r) >> 5] >> ((r) & 31)) & 1)
+
+static int __big_int_root_is_prime_u32(uint32_t n)
+{
+    uint32_t d;
+
+    if (n < 4) return n >= 2;
+    if ((n & 1) == 0) return 0;
+    for (d = 3; (uint64_t)d * d <= n; d += 2)
+    {
+        if (n % d == 0) return 0;
+    }
+    return 1;
+}
+
+static uint32_t __big_int_root_powm_u32(uint32_t base, uint32_t e, uint32_t m)
+{
+    uint64_t r = 1, b = base % m;
+
+    while (e != 0)
+    {
+        if (e & 1) r = r * b % m;
+        b = b * b % m;
+        e >>= 1;
+    }
+    return (uint32_t)r;
+}
+
+/* the next prime q = 1 mod p above q, 0 past a slot */
+static uint32_t __big_int_root_power_mod(uint32_t p, uint32_t q)
+{
+    do
+    {
+        if (q > 0xFFFFFFFF - 2 * p) return 0;
+        q += 2 * p;
+    } while (!__big_int_root_is_prime_u32(q));
+    return q;
+}
+
+/* 0 when |num| is certainly not a p-th power from the moduli after q,
+ * p odd prime */
+static int __big_int_root_power_residues(big_int_t *num, uint32_t p, uint32_t q)
+{
+    int tried;
+    uint32_t r;
+
+    for (tried = 1; tried != BIG_INT_ROOT_POWER_MODS; tried++)
+    {
+        if ((q = __big_int_root_power_mod(p, q)) == 0) break;
+        r = __big_int_slots_divrem_1(NULL, num->slot, num->slot_length, q);
+        if ((r != 0) && (__big_int_root_powm_u32(r, (q - 1) / p, q) != 1)) return 0;
+    }
+    return 1;
+}
+
+int big_int_is_square(big_int_t *num)
+{
+    int ret;
+    uint32_t r;
+    big_int_t *s = NULL, *rem = NULL;
+
+    if (num->sign == BIG_NUMBER_NEGATIVE) return 0;
+    if (!BIG_INT_ROOT_TABLE_HAS(big_int_root_square_64, num->slot[0] & 63)) return 0;
+    r = __big_int_slots_divrem_1(NULL, num->slot, num->slot_length, BIG_INT_ROOT_SQUARE_MOD);
+    if (!BIG_INT_ROOT_TABLE_HAS(big_int_root_square_63, r % 63)) return 0;
+    if (!BIG_INT_ROOT_TABLE_HAS(big_int_root_square_65, r % 65)) return 0;
+    if (!BIG_INT_ROOT_TABLE_HAS(big_int_root_square_11, r % 11)) return 0;
+
+    if ((s = big_int_new_from_int(0)) == NULL) return -1;
+    if ((rem = big_int_new_from_int(0)) == NULL) { big_int_destroy(s); return -1; }
+    ret = (big_int_sqrtrem(s, rem, num) != 0) ? -1 : big_int_is_zero(rem);
+    big_int_destroy(s);
+    big_int_destroy(rem);
+    return ret;
+}
+
+int big_int_is_perfect_power(big_int_t *num)
+{
+    int ret = 0;
+    size_t i, count;
+    char *composite = NULL;
+    uint32_t p, q, product, residue;
+    uint32_t exponents[BIG_INT_ROOT_POWER_GROUP], moduli[BIG_INT_ROOT_POWER_GROUP];
+    slot_t low;
+    size_t zeros = 0;
+    big_int_t *r = NULL, *rem = NULL;
+
+    /* 0, 1 and -1 */
+    if ((num->slot_length == 1) && (num->slot[0] <= 1)) return 1;
+    if ((num->sign == BIG_NUMBER_POSITIVE) && ((ret = big_int_is_square(num)) != 0)) return ret;
+    /* a^p has p | zeros when a is even */
+    while (num->slot[zeros / BIT_PER_SLOT] == 0) zeros += BIT_PER_SLOT;
+    for (low = num->slot[zeros / BIT_PER_SLOT]; (low & 1) == 0; low >>= 1) zeros++;
+
+    /* |a| >= 2, so p <= bits, odd composites sieved out */
+    if ((composite = (char *)calloc(num->bit_length + 1, 1)) == NULL) return -1;
+    for (p = 3; p * p <= num->bit_length; p += 2)
+    {
+        if (composite[p]) continue;
+        for (i = p * p; i <= num->bit_length; i += 2 * p) composite[i] = 1;
+    }
+    if ((r = big_int_new_from_int(0)) == NULL) goto fail;
+    if ((rem = big_int_new_from_int(0)) == NULL) goto fail;
+    p = 3;
+    while ((ret == 0) && (p <= num->bit_length))
+    {
+        /* exponents whose first moduli multiply within a slot
+         * share one pass over num */
+        count = 0;
+        product = 1;
+        for (; (p <= num->bit_length) && (count != BIG_INT_ROOT_POWER_GROUP); p += 2)
+        {
+            if ((zeros != 0) && (zeros % p != 0)) continue;
+            if (composite[p]) continue;
+            if ((q = __big_int_root_power_mod(p, 1)) == 0) continue;
+            if ((uint64_t)product * q > 0xFFFFFFFF) break;
+            exponents[count] = p;
+            moduli[count] = q;
+            product *= q;
+            count++;
+        }
+        if (count == 0) break;
+        residue = __big_int_slots_divrem_1(NULL, num->slot, num->slot_length, product);
+        for (i = 0; i != count; i++)
+        {
+            q = moduli[i];
+            if (((residue % q) != 0) && (__big_int_root_powm_u32(residue % q, (q - 1) / exponents[i], q) != 1)) continue;
+            if (!__big_int_root_power_residues(num, exponents[i], q)) continue;
+            if (big_int_rootrem(r, rem, num, exponents[i]) != 0) { ret = -1; break; }
+            if (big_int_is_zero(rem)) { ret = 1; break; }
+        }
+    }
+    goto done;
+fail:
+    ret = -1;
+done:
+    free(composite);
+    if (r != NULL) big_int_destroy(r);
+    if (rem != NULL) big_int_destroy(rem);
+    return ret;
+}
@@ -0,0 +1,48 @@
+/*
+   Big Integer Library - Integer Roots
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_ROOT_H_
+#define _BIG_INT_ROOT_H_
+
+#include "big_int.h"
+
+/* s = floor(sqrt(n)), r = n - s^2 (could be NULL), -1 returned for n < 0 */
+int big_int_sqrtrem(big_int_t *s, big_int_t *r, big_int_t *n);
+
+/* r = n^(1/k) rounded toward zero, rem = n - r^k (could be NULL),
+ * k >= 1, negative n only for odd k */
+int big_int_rootrem(big_int_t *r, big_int_t *rem, big_int_t *n, unsigned int k);
+int big_int_root(big_int_t *r, big_int_t *n, unsigned int k);
+
+/* 1 when num = a^2, 0 otherwise, small residues reject most
+ * non-squares before a root is taken */
+int big_int_is_square(big_int_t *num);
+/* 1 when num = a^k for some k >= 2, 0 otherwise */
+int big_int_is_perfect_power(big_int_t *num);
+
+#endif
@@ -0,0 +1,241 @@
+/*
+   Big Integer Library - RSA
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_prime.h"
+#include "big_int_powm.h"
+#include "big_int_gcd.h"
+#include "big_int_rsa.h"
+
+/* candidates tried upward from one random start */
+#define BIG_INT_RSA_SEARCH_STEPS 4096
+
+big_int_rsa_key_t *big_int_rsa_key_new(big_int_t *p, big_int_t *q, big_int_t *e)
+{
+    big_int_rsa_key_t *key;
+    big_int_t *p1 = NULL, *q1 = NULL, *lambda = NULL, *g = NULL;
+
+    if ((p->sign == BIG_NUMBER_NEGATIVE) || (q->sign == BIG_NUMBER_NEGATIVE) || \
+            ((p->slot[0] & 1) == 0) || ((q->slot[0] & 1) == 0) || \
+            (p->bit_length < 2) || (q->bit_length < 2) || (big_int_compare(p, q) == 0)) return NULL;
+    if ((key = (big_int_rsa_key_t *)malloc(sizeof(big_int_rsa_key_t))) == NULL) return NULL;
+    key->n = key->e = key->d = NULL;
+    key->p = key->q = key->dp = key->dq = key->qinv = NULL;
+    key->mont_p = key->mont_q = NULL;
+
+    if ((key->p = big_int_assign(p)) == NULL) goto fail;
+    if ((key->q = big_int_assign(q)) == NULL) goto fail;
+    if ((key->e = big_int_assign(e)) == NULL) goto fail;
+    if ((key->n = big_int_mul(p, q)) == NULL) goto fail;
+
+    /* lambda = lcm(p - 1, q - 1) */
+    if (((p1 = big_int_assign(p)) == NULL) || (big_int_dec(p1) != 0)) goto fail;
+    if (((q1 = big_int_assign(q)) == NULL) || (big_int_dec(q1) != 0)) goto fail;
+    if ((g = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_gcd(g, p1, q1) != 0) goto fail;
+    if ((lambda = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_divexact(lambda, p1, g) != 0) goto fail;
+    if (big_int_mul_to(lambda, q1) != 0) goto fail;
+
+    if ((key->d = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_invert(key->d, e, lambda) != 0) goto fail;
+    if ((key->dp = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_divrem_floor(NULL, key->dp, key->d, p1) != 0) goto fail;
+    if ((key->dq = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_divrem_floor(NULL, key->dq, key->d, q1) != 0) goto fail;
+    if ((key->qinv = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_invert(key->qinv, q, p) != 0) goto fail;
+
+    if ((key->mont_p = big_int_mont_ctx_new(p)) == NULL) goto fail;
+    if ((key->mont_q = big_int_mont_ctx_new(q)) == NULL) goto fail;
+
+    big_int_destroy(p1);
+    big_int_destroy(q1);
+    big_int_destroy(g);
+    big_int_destroy(lambda);
+    return key;
+fail:
+    if (p1 != NULL) big_int_destroy(p1);
+    if (q1 != NULL) big_int_destroy(q1);
+    if (g != NULL) big_int_destroy(g);
+    if (lambda != NULL) big_int_destroy(lambda);
+    big_int_rsa_key_destroy(key);
+    return NULL;
+}
+
+int big_int_rsa_key_destroy(big_int_rsa_key_t *key)
+{
+    if (key->n != NULL) big_int_destroy(key->n);
+    if (key->e != NULL) big_int_destroy(key->e);
+    if (key->d != NULL) big_int_destroy(key->d);
+    if (key->p != NULL) big_int_destroy(key->p);
+    if (key->q != NULL) big_int_destroy(key->q);
+    if (key->dp != NULL) big_int_destroy(key->dp);
+    if (key->dq != NULL) big_int_destroy(key->dq);
+    if (key->qinv != NULL) big_int_destroy(key->qinv);
+    if (key->mont_p != NULL) big_int_mont_ctx_destroy(key->mont_p);
+    if (key->mont_q != NULL) big_int_mont_ctx_destroy(key->mont_q);
+    free(key);
+    return 0;
+}
+
+/* prime of exactly bits bits with the two top bits set, so the
+ * product of two has the sum of their lengths, and gcd(p - 1, e) = 1 */
+static big_int_t *__big_int_rsa_prime(size_t bits, big_int_t *e)
+{
+    size_t step;
+    big_int_t *c = NULL, *t, *g;
+
+    t = big_int_new_from_int(0);
+    g = big_int_new_from_int(0);
+    if ((t == NULL) || (g == NULL)) goto fail;
+    for (;;)
+    {
+        if ((c = big_int_new_random(bits)) == NULL) goto fail;
+        c->slot_length = (bits + 31) >> 5;
+        c->slot[(bits - 1) >> 5] |= (slot_t)1 << ((bits - 1) & 31);
+        c->slot[(bits - 2) >> 5] |= (slot_t)1 << ((bits - 2) & 31);
+        c->slot[0] |= 1;
+        __big_int_normalize(c);
+        for (step = 0; (step != BIG_INT_RSA_SEARCH_STEPS) && (c->bit_length == bits); step++)
+        {
+            if ((prime_divide_test(c) == 0) && (miller_rabin(c, (int)bits) == 1))
+            {
+                if (big_int_assign_to(t, c) != 0) goto fail;
+                if (big_int_dec(t) != 0) goto fail;
+                if (big_int_gcd(g, t, e) != 0) goto fail;
+                if ((g->slot_length == 1) && (g->slot[0] == 1)) goto done;
+            }
+            if (big_int_add_to_u16(c, 2) != 0) goto fail;
+        }
+        big_int_destroy(c);
+        c = NULL;
+    }
+fail:
+    if (c != NULL) big_int_destroy(c);
+    c = NULL;
+done:
+    if (t != NULL) big_int_destroy(t);
+    if (g != NULL) big_int_destroy(g);
+    return c;
+}
+
+typedef struct
+{
+    size_t bits[2];
+    big_int_t *e;
+    big_int_t *primes[2];
+} big_int_rsa_search_t;
+
+static void __big_int_rsa_search_job(void *arg, size_t idx)
+{
+    big_int_rsa_search_t *search = (big_int_rsa_search_t *)arg;
+
+    search->primes[idx] = __big_int_rsa_prime(search->bits[idx], search->e);
+}
+
+big_int_rsa_key_t *big_int_rsa_keygen(size_t bits, big_int_t *e, big_int_worker_pool_t *pool)
+{
+    size_t idx;
+    big_int_rsa_search_t search;
+    big_int_rsa_key_t *key = NULL;
+
+    if (bits < BIG_INT_RSA_BITS_MIN) return NULL;
+    search.bits[0] = bits - (bits >> 1);
+    search.bits[1] = bits >> 1;
+    search.e = e;
+    search.primes[0] = search.primes[1] = NULL;
+    do
+    {
+        for (idx = 0; idx != 2; idx++)
+        {
+            if (search.primes[idx] != NULL) big_int_destroy(search.primes[idx]);
+            search.primes[idx] = NULL;
+        }
+        if (pool != NULL)
+        {
+            if (big_int_worker_pool_run(pool, __big_int_rsa_search_job, &search, 2) != 0) goto fail;
+        }
+        else
+        {
+            for (idx = 0; idx != 2; idx++) __big_int_rsa_search_job(&search, idx);
+        }
+        if ((search.primes[0] == NULL) || (search.primes[1] == NULL)) goto fail;
+        /* equal halves of a small key may meet */
+    } while (big_int_compare(search.primes[0], search.primes[1]) == 0);
+    key = big_int_rsa_key_new(search.primes[0], search.primes[1], e);
+fail:
+    for (idx = 0; idx != 2; idx++)
+    {
+        if (search.primes[idx] != NULL) big_int_destroy(search.primes[idx]);
+    }
+    return key;
+}
+
+int big_int_rsa_public(big_int_rsa_key_t *key, big_int_t *r, big_int_t *m)
+{
+    return big_int_powm(r, m, key->e, key->n);
+}
+
+int big_int_rsa_private(big_int_rsa_key_t *key, big_int_t *r, big_int_t *c)
+{
+    int ret = -1;
+    size_t scratch_size;
+    slot_t *scratch = NULL;
+    big_int_t *mq = NULL, *mp = NULL, *t = NULL;
+
+    /* the contexts of the key are only read, the scratch is this call's */
+    scratch_size = big_int_mont_scratch_size(key->mont_p);
+    if (big_int_mont_scratch_size(key->mont_q) > scratch_size) scratch_size = big_int_mont_scratch_size(key->mont_q);
+    if ((scratch = (slot_t *)calloc(scratch_size, sizeof(slot_t))) == NULL) return -1;
+    /* m_q = c ^ dq mod q, m_p = c ^ dp mod p */
+    if ((mq = big_int_new_from_int(0)) == NULL) goto fail;
+    if ((mp = big_int_new_from_int(0)) == NULL) goto fail;
+    if ((t = big_int_new_from_int(0)) == NULL) goto fail;
+    if (big_int_powm_mont_with(key->mont_q, scratch, mq, c, key->dq) != 0) goto fail;
+    if (big_int_powm_mont_with(key->mont_p, scratch, mp, c, key->dp) != 0) goto fail;
+    /* Garner: m = m_q + q ((m_p - m_q) qinv mod p) */
+    if (big_int_divrem_floor(NULL, t, mq, key->p) != 0) goto fail;
+    if ((big_int_compare(mp, t) < 0) && (big_int_add_to(mp, key->p) != 0)) goto fail;
+    if (big_int_sub_to(mp, t) != 0) goto fail;
+    if (big_int_mul_to(mp, key->qinv) != 0) goto fail;
+    if (big_int_divrem_floor(NULL, mp, mp, key->p) != 0) goto fail;
+    if (big_int_mul_to(mp, key->q) != 0) goto fail;
+    if (big_int_add_to(mp, mq) != 0) goto fail;
+    __big_int_move_to(r, mp);
+    mp = NULL;
+    ret = 0;
+fail:
+    if (mq != NULL) big_int_destroy(mq);
+    if (mp != NULL) big_int_destroy(mp);
+    if (t != NULL) big_int_destroy(t);
+    free(scratch);
+    return ret;
+}
@@ -0,0 +1,65 @@
+/*
+   Big Integer Library - RSA
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_RSA_H_
+#define _BIG_INT_RSA_H_
+
+#include "big_int.h"
+#include "big_int_montgomery.h"
+#include "big_int_worker_pool.h"
+
+#define BIG_INT_RSA_BITS_MIN 64
+
+/* RSA key with its CRT form, the reduction contexts for p and q
+ * are built with the key and only read afterwards, so threads can
+ * share a key */
+typedef struct big_int_rsa_key
+{
+    big_int_t *n, *e, *d;
+    big_int_t *p, *q;
+    big_int_t *dp, *dq; /* d mod (p - 1), d mod (q - 1) */
+    big_int_t *qinv; /* q^-1 mod p */
+    /* internal */
+    big_int_mont_ctx_t *mont_p, *mont_q;
+} big_int_rsa_key_t;
+
+/* key from distinct odd primes p, q and the public exponent e,
+ * d = e^-1 mod lcm(p - 1, q - 1), NULL if e is not invertible */
+big_int_rsa_key_t *big_int_rsa_key_new(big_int_t *p, big_int_t *q, big_int_t *e);
+int big_int_rsa_key_destroy(big_int_rsa_key_t *key);
+
+/* n of exactly bits bits (>= BIG_INT_RSA_BITS_MIN), p and q are
+ * searched at the same time on the pool (in the caller when NULL) */
+big_int_rsa_key_t *big_int_rsa_keygen(size_t bits, big_int_t *e, big_int_worker_pool_t *pool);
+
+/* r = m ^ e mod n */
+int big_int_rsa_public(big_int_rsa_key_t *key, big_int_t *r, big_int_t *m);
+/* r = c ^ d mod n by two half size exponentiations and Garner */
+int big_int_rsa_private(big_int_rsa_key_t *key, big_int_t *r, big_int_t *c);
+
+#endif
@@ -0,0 +1,451 @@
+/*
+   Big Integer Library - Special Form Modulus Reduction
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+
+#include "big_int.h"
+#include "big_int_special.h"
+
+#define BIT_PER_SLOT (32)
+#define MUL_SLOT(x) ((uint64_t)(x)<<5)
+#define MAX(a,b) ((a)>(b)?(a):(b))
+#define MIN(a,b) ((a)<(b)?(a):(b))
+
+/* Reduction by folding
+ * m = 2^k - c, x = hi * 2^k + lo = lo + hi * c (mod m),
+ * each fold takes away about k - bits(c) bits without a division
+ * or a multiplication by a reciprocal, c is kept as a few terms
+ * sign * coef * 2^shift. Folds may turn the value negative, then
+ * the magnitude is carried on with the sign flipped. */
+
+#define BIG_INT_SPECIAL_MAX_TERMS 8
+
+struct big_int_special_ctx
+{
+    big_int_t *modulus;
+    size_t k;
+    int term_count;
+    int term_sign[BIG_INT_SPECIAL_MAX_TERMS];
+    slot_t term_coef[BIG_INT_SPECIAL_MAX_TERMS];
+    size_t term_shift[BIG_INT_SPECIAL_MAX_TERMS];
+    int has_negative; /* any term is negative */
+    size_t c_slots; /* slots of hi * c over hi */
+    /* scratch, all of 'width' slots */
+    size_t width;
+    slot_t *m; /* modulus padded */
+    slot_t *x, *p, *n, *hi, *t;
+    size_t x_length; /* slots used in x */
+};
+
+static size_t __big_int_special_bit_length(const slot_t *a, size_t n)
+{
+    slot_t top;
+    size_t bits = 0;
+
+    while ((n != 0) && (a[n - 1] == 0)) n--;
+    if (n == 0) return 0;
+    for (top = a[n - 1]; top != 0; top >>= 1) bits++;
+    return MUL_SLOT(n - 1) + bits;
+}
+
+static int __big_int_special_compare(const slot_t *a, const slot_t *b, size_t n)
+{
+    while (n-- != 0)
+    {
+        if (a[n] != b[n]) return (a[n] > b[n]) ? 1 : -1;
+    }
+    return 0;
+}
+
+/* a[0..n-1] -= b[0..n-1], a >= b */
+static void __big_int_special_sub(slot_t *a, const slot_t *b, size_t n)
+{
+    size_t i;
+    slot_t borrow = 0, tmp;
+
+    for (i = 0; i != n; i++)
+    {
+        tmp = a[i];
+        a[i] = tmp - b[i] - borrow;
+        borrow = (tmp < b[i]) || ((tmp == b[i]) && borrow);
+    }
+}
+
+/* acc[0..n-1] += a[0..an-1] * 2^shift */
+static void __big_int_special_add_shifted(slot_t *acc, size_t n, const slot_t *a, size_t an, size_t shift)
+{
+    size_t i, q = shift / BIT_PER_SLOT, r = shift % BIT_PER_SLOT;
+    slot_t value, carry = 0;
+    uint64_t tmp;
+
+    for (i = 0; (i <= an) && (q + i < n); i++)
+    {
+        value = (i < an) ? (a[i] << r) : 0;
+        if ((r != 0) && (i != 0)) value |= a[i - 1] >> (BIT_PER_SLOT - r);
+        tmp = (uint64_t)acc[q + i] + value + carry;
+        acc[q + i] = (slot_t)tmp;
+        carry = (slot_t)(tmp >> BIT_PER_SLOT);
+    }
+    for (i = q + i; (carry != 0) && (i < n); i++)
+    {
+        acc[i] += carry;
+        carry = (acc[i] == 0);
+    }
+}
+
+/* fold ctx->x below 2^k, then into [0, m),
+ * the scratch buffers are kept zero beyond their used slots */
+static void __big_int_special_reduce_slots(big_int_special_ctx_t *ctx)
+{
+    size_t i, w = ctx->width, k = ctx->k;
+    size_t q = k / BIT_PER_SLOT, r = k % BIT_PER_SLOT;
+    size_t hi_length, length;
+    int term_idx, negative = 0;
+    slot_t *swap, *hi_term;
+
+    while ((ctx->x_length > q + 1) || ((ctx->x_length == q + 1) && ((ctx->x[q] >> r) != 0)))
+    {
+        /* hi = x / 2^k */
+        hi_length = ctx->x_length - q;
+        for (i = 0; i != hi_length; i++)
+        {
+            ctx->hi[i] = ctx->x[q + i] >> r;
+            if ((r != 0) && (q + i + 1 < ctx->x_length)) ctx->hi[i] |= ctx->x[q + i + 1] << (BIT_PER_SLOT - r);
+        }
+        while ((hi_length > 1) && (ctx->hi[hi_length - 1] == 0)) hi_length--;
+        /* lo + hi * c fits in 'length' slots */
+        length = MIN(w, MAX(q + 1, hi_length + ctx->c_slots) + 1);
+        /* p = x mod 2^k */
+        for (i = 0; i != q; i++) ctx->p[i] = ctx->x[i];
+        if (r != 0) ctx->p[q] = ctx->x[q] & ((((slot_t)1) << r) - 1);
+        /* p - n = lo + hi * c */
+        for (term_idx = 0; term_idx != ctx->term_count; term_idx++)
+        {
+            hi_term = ctx->hi;
+            if (ctx->term_coef[term_idx] != 1)
+            {
+                for (i = 0; i != hi_length; i++) ctx->t[i] = 0;
+                ctx->t[hi_length] = __big_int_slots_addmul_1(ctx->t, ctx->hi, hi_length, ctx->term_coef[term_idx]);
+                hi_term = ctx->t;
+            }
+            __big_int_special_add_shifted( \
+                    (ctx->term_sign[term_idx] == BIG_NUMBER_POSITIVE) ? ctx->p : ctx->n, \
+                    length, hi_term, hi_length + (hi_term == ctx->t), ctx->term_shift[term_idx]);
+        }
+        for (i = 0; i != ctx->x_length; i++) ctx->x[i] = 0;
+        if (!ctx->has_negative || (__big_int_special_compare(ctx->p, ctx->n, length) >= 0))
+        {
+            if (ctx->has_negative) __big_int_special_sub(ctx->p, ctx->n, length);
+            swap = ctx->x; ctx->x = ctx->p; ctx->p = swap;
+        }
+        else
+        {
+            __big_int_special_sub(ctx->n, ctx->p, length);
+            for (i = 0; i != length; i++) ctx->p[i] = 0;
+            swap = ctx->x; ctx->x = ctx->n; ctx->n = swap;
+            negative = !negative;
+        }
+        if (ctx->has_negative) for (i = 0; i != length; i++) ctx->n[i] = 0;
+        ctx->x_length = length;
+        while ((ctx->x_length > 1) && (ctx->x[ctx->x_length - 1] == 0)) ctx->x_length--;
+    }
+    /* x < 2^k, less than 2m */
+    length = MAX(ctx->x_length, ctx->modulus->slot_length);
+    if (__big_int_special_compare(ctx->x, ctx->m, length) >= 0) __big_int_special_sub(ctx->x, ctx->m, length);
+    if (negative && (__big_int_special_bit_length(ctx->x, length) != 0))
+    {
+        for (i = 0; i != length; i++) ctx->p[i] = ctx->m[i];
+        __big_int_special_sub(ctx->p, ctx->x, length);
+        for (i = 0; i != length; i++) ctx->x[i] = 0;
+        swap = ctx->x; ctx->x = ctx->p; ctx->p = swap;
+    }
+    ctx->x_length = length;
+}
+
+/* split signed c into terms, -1 when c is too large or too dense */
+static int __big_int_special_terms(big_int_special_ctx_t *ctx, big_int_t *c)
+{
+    size_t bit_idx;
+    int bit_h, bit_c;
+    big_int_t *h = NULL;
+
+    ctx->term_count = 0;
+    if (big_int_is_zero(c)) return 0;
+    if (c->bit_length > (ctx->k >> 1)) return -1;
+    if (c->slot_length == 1)
+    {
+        ctx->term_sign[0] = c->sign;
+        ctx->term_coef[0] = c->slot[0];
+        ctx->term_shift[0] = 0;
+        ctx->term_count = 1;
+        return 0;
+    }
+
+    /* non-adjacent form, the digit i - 1 is bit i of 3c minus bit i of c */
+    if ((h = big_int_new_from_int(3)) == NULL) return -1;
+    if (big_int_mul_to(h, c) != 0) goto fail;
+    for (bit_idx = 1; bit_idx <= h->bit_length; bit_idx++)
+    {
+        bit_h = (bit_idx < h->bit_length) ? ((h->slot[bit_idx / BIT_PER_SLOT] >> (bit_idx % BIT_PER_SLOT)) & 1) : 0;
+        bit_c = (bit_idx < c->bit_length) ? ((c->slot[bit_idx / BIT_PER_SLOT] >> (bit_idx % BIT_PER_SLOT)) & 1) : 0;
+        if (bit_h == bit_c) continue;
+        if (ctx->term_count == BIG_INT_SPECIAL_MAX_TERMS) goto fail;
+        ctx->term_sign[ctx->term_count] = bit_h ? c->sign : !c->sign;
+        ctx->term_coef[ctx->term_count] = 1;
+        ctx->term_shift[ctx->term_count] = bit_idx - 1;
+        ctx->term_count++;
+    }
+    big_int_destroy(h);
+    return 0;
+fail:
+    big_int_destroy(h);
+    ctx->term_count = 0;
+    return -1;
+}
+
+/* build the context of m = 2^k - c, NULL if the form does not fit */
+static big_int_special_ctx_t *__big_int_special_ctx_build(big_int_t *m, size_t k, big_int_t *c)
+{
+    size_t i, w;
+    big_int_special_ctx_t *ctx;
+
+    if ((m->sign == BIG_NUMBER_NEGATIVE) || big_int_is_zero(m)) return NULL;
+    if ((ctx = (big_int_special_ctx_t *)malloc(sizeof(big_int_special_ctx_t))) == NULL) return NULL;
+    ctx->modulus = NULL;
+    ctx->m = ctx->x = ctx->p = ctx->n = ctx->hi = ctx->t = NULL;
+    ctx->k = k;
+    if (__big_int_special_terms(ctx, c) != 0) goto fail;
+    if ((ctx->modulus = big_int_assign(m)) == NULL) goto fail;
+
+    /* room for the square of the modulus and the growth of a fold */
+    w = ctx->width = ((m->bit_length << 1) >> 5) + 3;
+    ctx->m = (slot_t *)malloc(sizeof(slot_t) * w);
+    ctx->x = (slot_t *)malloc(sizeof(slot_t) * w);
+    ctx->p = (slot_t *)malloc(sizeof(slot_t) * w);
+    ctx->n = (slot_t *)malloc(sizeof(slot_t) * w);
+    ctx->hi = (slot_t *)malloc(sizeof(slot_t) * w);
+    ctx->t = (slot_t *)malloc(sizeof(slot_t) * (w + 1));
+    if (ctx->m == NULL || ctx->x == NULL || ctx->p == NULL || ctx->n == NULL || ctx->hi == NULL || ctx->t == NULL) goto fail;
+    for (i = 0; i != w; i++)
+    {
+        ctx->m[i] = (i < m->slot_length) ? m->slot[i] : 0;
+        ctx->x[i] = ctx->p[i] = ctx->n[i] = 0;
+    }
+    ctx->x_length = 1;
+    ctx->has_negative = 0;
+    ctx->c_slots = 1;
+    for (i = 0; i != (size_t)ctx->term_count; i++)
+    {
+        if (ctx->term_sign[i] == BIG_NUMBER_NEGATIVE) ctx->has_negative = 1;
+        ctx->c_slots = MAX(ctx->c_slots, ctx->term_shift[i] / BIT_PER_SLOT + 2);
+    }
+    return ctx;
+fail:
+    big_int_special_ctx_destroy(ctx);
+    return NULL;
+}
+
+/* m = 2^k - c, c = 2^k - m */
+static big_int_special_ctx_t *__big_int_special_ctx_try(big_int_t *m, size_t k)
+{
+    big_int_t *c;
+    big_int_special_ctx_t *ctx = NULL;
+
+    if ((c = big_int_new_from_int(1)) == NULL) return NULL;
+    if ((big_int_left_shift(c, (int)k) == 0) && (big_int_sub_to(c, m) == 0))
+        ctx = __big_int_special_ctx_build(m, k, c);
+    big_int_destroy(c);
+    return ctx;
+}
+
+big_int_special_ctx_t *big_int_special_ctx_new(big_int_t *modulus)
+{
+    size_t bit_length = modulus->bit_length;
+    big_int_special_ctx_t *ctx;
+    slot_t below;
+
+    if ((modulus->sign == BIG_NUMBER_NEGATIVE) || big_int_is_zero(modulus)) return NULL;
+    /* quick reject, the slot below the top one must be all ones
+     * (2^k - c) or all zeros (2^k + c) when it is above c */
+    if ((modulus->slot_length >= 3) && (MUL_SLOT(modulus->slot_length - 2) > (bit_length >> 1)))
+    {
+        below = modulus->slot[modulus->slot_length - 2];
+        if ((below != 0) && (below != 0xFFFFFFFF)) return NULL;
+    }
+    if ((ctx = __big_int_special_ctx_try(modulus, bit_length)) != NULL) return ctx;
+    return __big_int_special_ctx_try(modulus, bit_length - 1);
+}
+
+big_int_special_ctx_t *big_int_special_ctx_new_form(size_t k, big_int_t *c)
+{
+    big_int_t *m;
+    big_int_special_ctx_t *ctx = NULL;
+
+    if ((m = big_int_new_from_int(1)) == NULL) return NULL;
+    if ((big_int_left_shift(m, (int)k) == 0) && (big_int_sub_to(m, c) == 0))
+        ctx = __big_int_special_ctx_build(m, k, c);
+    big_int_destroy(m);
+    return ctx;
+}
+
+int big_int_special_ctx_destroy(big_int_special_ctx_t *ctx)
+{
+    if (ctx->modulus != NULL) big_int_destroy(ctx->modulus);
+    if (ctx->m != NULL) free(ctx->m);
+    if (ctx->x != NULL) free(ctx->x);
+    if (ctx->p != NULL) free(ctx->p);
+    if (ctx->n != NULL) free(ctx->n);
+    if (ctx->hi != NULL) free(ctx->hi);
+    if (ctx->t != NULL) free(ctx->t);
+    free(ctx);
+    return 0;
+}
+
+big_int_t *big_int_special_ctx_modulus(big_int_special_ctx_t *ctx)
+{
+    return ctx->modulus;
+}
+
+/* write the result into num */
+static int __big_int_special_store(big_int_special_ctx_t *ctx, big_int_t *num)
+{
+    size_t i, n = ctx->modulus->slot_length;
+
+    if (__big_int_reserve(num, n) != 0) return -1;
+    for (i = 0; i != n; i++) num->slot[i] = ctx->x[i];
+    for (; i < num->slot_length; i++) num->slot[i] = 0;
+    for (i = 0; i != ctx->x_length; i++) ctx->x[i] = 0;
+    ctx->x_length = 1;
+    num->slot_length = n;
+    num->sign = BIG_NUMBER_POSITIVE;
+    __big_int_normalize(num);
+    return 0;
+}
+
+/* r = t mod m with long division, for values out of the fast path */
+static int __big_int_special_fallback(big_int_special_ctx_t *ctx, big_int_t *r, big_int_t *t)
+{
+    if (big_int_divrem_floor(NULL, t, t, ctx->modulus) != 0)
+    {
+        big_int_destroy(t);
+        return -1;
+    }
+    __big_int_move_to(r, t);
+    return 0;
+}
+
+/* num = num mod m */
+int big_int_special_reduce(big_int_special_ctx_t *ctx, big_int_t *num)
+{
+    size_t i;
+
+    if ((num->sign == BIG_NUMBER_NEGATIVE) || (num->bit_length > (ctx->modulus->bit_length << 1)))
+    {
+        return big_int_divrem_floor(NULL, num, num, ctx->modulus);
+    }
+    for (i = 0; i != num->slot_length; i++) ctx->x[i] = num->slot[i];
+    ctx->x_length = num->slot_length;
+    __big_int_special_reduce_slots(ctx);
+    return __big_int_special_store(ctx, num);
+}
+
+/* r = a * b mod m */
+int big_int_special_mulmod(big_int_special_ctx_t *ctx, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    big_int_t *t;
+
+    if (a == b) return big_int_special_sqrmod(ctx, r, a);
+    if ((a->sign == BIG_NUMBER_NEGATIVE) || (b->sign == BIG_NUMBER_NEGATIVE) || \
+            (a->bit_length > ctx->modulus->bit_length) || (b->bit_length > ctx->modulus->bit_length))
+    {
+        if ((t = big_int_mul(a, b)) == NULL) return -1;
+        return __big_int_special_fallback(ctx, r, t);
+    }
+    __big_int_slots_mul(ctx->x, a->slot, a->slot_length, b->slot, b->slot_length);
+    ctx->x_length = a->slot_length + b->slot_length;
+    __big_int_special_reduce_slots(ctx);
+    return __big_int_special_store(ctx, r);
+}
+
+/* r = a^2 mod m */
+int big_int_special_sqrmod(big_int_special_ctx_t *ctx, big_int_t *r, big_int_t *a)
+{
+    big_int_t *t;
+
+    if ((a->sign == BIG_NUMBER_NEGATIVE) || (a->bit_length > ctx->modulus->bit_length))
+    {
+        if ((t = big_int_mul(a, a)) == NULL) return -1;
+        return __big_int_special_fallback(ctx, r, t);
+    }
+    __big_int_slots_sqr(ctx->x, a->slot, a->slot_length);
+    ctx->x_length = a->slot_length << 1;
+    __big_int_special_reduce_slots(ctx);
+    return __big_int_special_store(ctx, r);
+}
+
+/* a copy of the context running on the caller's scratch, which has
+ * to start out zero like the context's own, the context is only read */
+static void __big_int_special_borrow(big_int_special_ctx_t *local, big_int_special_ctx_t *ctx, slot_t *scratch)
+{
+    *local = *ctx;
+    local->x = scratch;
+    local->p = local->x + ctx->width;
+    local->n = local->p + ctx->width;
+    local->hi = local->n + ctx->width;
+    local->t = local->hi + ctx->width;
+    local->x_length = 1;
+}
+
+size_t big_int_special_scratch_size(big_int_special_ctx_t *ctx)
+{
+    return ctx->width * 5 + 1;
+}
+
+int big_int_special_reduce_with(big_int_special_ctx_t *ctx, slot_t *scratch, big_int_t *num)
+{
+    big_int_special_ctx_t local;
+
+    __big_int_special_borrow(&local, ctx, scratch);
+    return big_int_special_reduce(&local, num);
+}
+
+int big_int_special_mulmod_with(big_int_special_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a, big_int_t *b)
+{
+    big_int_special_ctx_t local;
+
+    __big_int_special_borrow(&local, ctx, scratch);
+    return big_int_special_mulmod(&local, r, a, b);
+}
+
+int big_int_special_sqrmod_with(big_int_special_ctx_t *ctx, slot_t *scratch, big_int_t *r, big_int_t *a)
+{
+    big_int_special_ctx_t local;
+
+    __big_int_special_borrow(&local, ctx, scratch);
+    return big_int_special_sqrmod(&local, r, a);
+}
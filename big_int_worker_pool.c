@@ -0,0 +1,161 @@
+/*
+   Big Integer Library - Worker Pool
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+
+#include "big_int_worker_pool.h"
+
+struct big_int_worker_pool
+{
+    pthread_t *threads;
+    size_t thread_count;
+    pthread_mutex_t run_lock; /* one run at a time */
+    pthread_mutex_t lock;
+    pthread_cond_t work_cond;
+    pthread_cond_t done_cond;
+    int quit;
+    /* current run */
+    big_int_worker_job_t job;
+    void *arg;
+    size_t count;
+    size_t next;
+    size_t pending;
+};
+
+/* take jobs until none is left, called with the lock held */
+static void __big_int_worker_pool_drain(big_int_worker_pool_t *pool)
+{
+    size_t idx;
+
+    while (pool->next != pool->count)
+    {
+        idx = pool->next++;
+        pthread_mutex_unlock(&pool->lock);
+        pool->job(pool->arg, idx);
+        pthread_mutex_lock(&pool->lock);
+        if (--pool->pending == 0) pthread_cond_broadcast(&pool->done_cond);
+    }
+}
+
+static void *__big_int_worker_pool_main(void *data)
+{
+    big_int_worker_pool_t *pool = (big_int_worker_pool_t *)data;
+
+    pthread_mutex_lock(&pool->lock);
+    for (;;)
+    {
+        while (!pool->quit && (pool->next == pool->count)) pthread_cond_wait(&pool->work_cond, &pool->lock);
+        if (pool->quit) break;
+        __big_int_worker_pool_drain(pool);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+big_int_worker_pool_t *big_int_worker_pool_new(size_t threads)
+{
+    long cpus;
+    big_int_worker_pool_t *new_pool = NULL;
+
+    if (threads == 0)
+    {
+        cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        /* the caller works too */
+        threads = (cpus > 1) ? (size_t)(cpus - 1) : 1;
+    }
+    if ((new_pool = (big_int_worker_pool_t *)malloc(sizeof(big_int_worker_pool_t))) == NULL) return NULL;
+    new_pool->thread_count = 0;
+    new_pool->quit = 0;
+    new_pool->job = NULL;
+    new_pool->arg = NULL;
+    new_pool->count = 0;
+    new_pool->next = 0;
+    new_pool->pending = 0;
+    pthread_mutex_init(&new_pool->run_lock, NULL);
+    pthread_mutex_init(&new_pool->lock, NULL);
+    pthread_cond_init(&new_pool->work_cond, NULL);
+    pthread_cond_init(&new_pool->done_cond, NULL);
+    if ((new_pool->threads = (pthread_t *)malloc(sizeof(pthread_t) * threads)) == NULL) goto fail;
+    for (; new_pool->thread_count != threads; new_pool->thread_count++)
+    {
+        if (pthread_create(&new_pool->threads[new_pool->thread_count], NULL, \
+                    __big_int_worker_pool_main, new_pool) != 0) goto fail;
+    }
+    return new_pool;
+fail:
+    big_int_worker_pool_destroy(new_pool);
+    return NULL;
+}
+
+int big_int_worker_pool_destroy(big_int_worker_pool_t *pool)
+{
+    size_t idx;
+
+    if (pool == NULL) return 0;
+    pthread_mutex_lock(&pool->lock);
+    pool->quit = 1;
+    pthread_cond_broadcast(&pool->work_cond);
+    pthread_mutex_unlock(&pool->lock);
+    for (idx = 0; idx != pool->thread_count; idx++) pthread_join(pool->threads[idx], NULL);
+    if (pool->threads != NULL) free(pool->threads);
+    pthread_cond_destroy(&pool->done_cond);
+    pthread_cond_destroy(&pool->work_cond);
+    pthread_mutex_destroy(&pool->lock);
+    pthread_mutex_destroy(&pool->run_lock);
+    free(pool);
+    return 0;
+}
+
+size_t big_int_worker_pool_threads(big_int_worker_pool_t *pool)
+{
+    return pool->thread_count;
+}
+
+int big_int_worker_pool_run(big_int_worker_pool_t *pool, big_int_worker_job_t job, void *arg, size_t count)
+{
+    if (count == 0) return 0;
+    pthread_mutex_lock(&pool->run_lock);
+    pthread_mutex_lock(&pool->lock);
+    pool->job = job;
+    pool->arg = arg;
+    pool->count = count;
+    pool->next = 0;
+    pool->pending = count;
+    pthread_cond_broadcast(&pool->work_cond);
+    __big_int_worker_pool_drain(pool);
+    while (pool->pending != 0) pthread_cond_wait(&pool->done_cond, &pool->lock);
+    pool->job = NULL;
+    pool->arg = NULL;
+    pool->count = 0;
+    pool->next = 0;
+    pthread_mutex_unlock(&pool->lock);
+    pthread_mutex_unlock(&pool->run_lock);
+    return 0;
+}
@@ -0,0 +1,48 @@
+/*
+   Big Integer Library - Worker Pool
+   Copyright (c) 2013-2014 Cheryl Natsu 
+   All rights reserved.
+
+   Redistribution and use in source and binary forms, with or without
+   modification, are permitted provided that the following conditions
+   are met:
+   1. Redistributions of source code must retain the above copyright
+   notice, this list of conditions and the following disclaimer.
+   2. Redistributions in binary form must reproduce the above copyright
+   notice, this list of conditions and the following disclaimer in the
+   documentation and/or other materials provided with the distribution.
+   3. The name of the authors may not be used to endorse or promote products
+   derived from this software without specific prior written permission.
+
+   THIS SOFTWARE IS PROVIDED BY THE AUTHOR ''AS IS'' AND ANY EXPRESS OR
+   IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES
+   OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE DISCLAIMED.
+   IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT, INDIRECT,
+   INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT
+   NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE,
+   DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY
+   THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+   (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+   THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+   */
+
+#ifndef _BIG_INT_WORKER_POOL_H_
+#define _BIG_INT_WORKER_POOL_H_
+
+#include <stddef.h>
+
+/* Fixed set of worker threads running parallel loops,
+ * job(arg, idx) is called once for every idx in [0, count) */
+typedef struct big_int_worker_pool big_int_worker_pool_t;
+typedef void (*big_int_worker_job_t)(void *arg, size_t idx);
+
+/* threads besides the caller, 0 for one less than the online cpus */
+big_int_worker_pool_t *big_int_worker_pool_new(size_t threads);
+int big_int_worker_pool_destroy(big_int_worker_pool_t *pool);
+size_t big_int_worker_pool_threads(big_int_worker_pool_t *pool);
+
+/* the calling thread takes part, returns when all jobs are done,
+ * runs on the same pool are serialized */
+int big_int_worker_pool_run(big_int_worker_pool_t *pool, big_int_worker_job_t job, void *arg, size_t count);
+
+#endif
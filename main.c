@@ -28,6 +28,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include "argsparse.h"
 
@@ -35,6 +36,10 @@
 #include "big_int_rand.h"
 #include "big_int_prime.h"
 #include "big_int_fibonacci.h"
+#include "big_int_powm.h"
+#include "big_int_rsa.h"
+#include "big_int_root.h"
+#include "big_int_factorial.h"
 
 
 static int show_version(void)
@@ -57,14 +62,18 @@ static int show_help(void)
         "mul <num1> <num2>\n"
         "div <num1> <num2>\n"
         "mod <num1> <num2>\n"
+        "sqrt <num>\n"
         "\n"
         "Public-Key Cryptography:\n"
         "random    <length:bit>     Random Number generate\n"
         "prime     <length:bit>     Big prime number generate\n"
         "dh        <length:bit>     Diffie–Hellman key exchange\n"
+        "rsa-keygen <length:bit>    RSA key generate\n"
+        "rsa-bench <length:bit>     RSA private operation, CRT against plain\n"
         "\n"
         "Others:\n"
         "fib       <n:int>          nth item in fibonacci array\n"
+        "fac       <n:int>          n factorial\n"
         "";
     show_version();
     puts(info);
@@ -147,6 +156,22 @@ int mod_op(char *s_num1, char *s_num2)
 }
 
 
+/* Square root */
+int sqrt_op(char *s_num)
+{
+    big_int_t *num = big_int_new_from_str(s_num);
+    big_int_t *rem = big_int_new_from_int(0);
+
+    big_int_sqrtrem(num, rem, num);
+    big_int_print(num);printf(" ");
+    big_int_print(rem);printf("\n");fflush(stdout);
+    big_int_destroy(num);
+    big_int_destroy(rem);
+
+    return 0;
+}
+
+
 /* Random number generator */
 int random_generate(size_t length)
 {
@@ -182,6 +207,7 @@ int dh(size_t length)
     big_int_t *private_alice, *private_bob;
     big_int_t *public_alice, *public_bob;
     big_int_t *password_alice = NULL, *password_bob = NULL;
+    big_int_fixed_base_ctx_t *g_ctx;
 
     p = big_int_new_prime(128*3);
     g = big_int_new_from_int(2);
@@ -196,20 +222,25 @@ int dh(size_t length)
 
     fflush(stdout);
 
-    public_alice = big_int_assign(g);
-    big_int_pow_mod_to(public_alice, private_alice, p);
+    /* both public keys are powers of the same g */
+    g_ctx = big_int_fixed_base_ctx_new(g, p, length);
+
+    public_alice = big_int_new_from_int(0);
+    big_int_powm_fixed_base(g_ctx, public_alice, private_alice);
+
+    public_bob = big_int_new_from_int(0);
+    big_int_powm_fixed_base(g_ctx, public_bob, private_bob);
 
-    public_bob = big_int_assign(g);
-    big_int_pow_mod_to(public_bob, private_bob, p);
+    big_int_fixed_base_ctx_destroy(g_ctx);
 
     printf("public_alice="); printf("0x"); big_int_print(public_alice); printf("\n");
     printf("public_bob="); printf("0x"); big_int_print(public_bob); printf("\n");
 
     password_alice = big_int_assign(public_bob);
-    big_int_pow_mod_to(password_alice, private_alice, p);
+    big_int_powm(password_alice, password_alice, private_alice, p);
 
     password_bob = big_int_assign(public_alice);
-    big_int_pow_mod_to(password_bob, private_bob, p);
+    big_int_powm(password_bob, password_bob, private_bob, p);
 
     printf("password_alice = "); printf("0x"); big_int_print(password_alice); printf("\n");
     printf("password_bob   = "); printf("0x"); big_int_print(password_bob); printf("\n");
@@ -229,6 +260,102 @@ int dh(size_t length)
 }
 
 
+/* RSA key generation, p and q are searched on two threads */
+static big_int_rsa_key_t *rsa_keygen_on_pool(size_t length)
+{
+    big_int_t *e;
+    big_int_worker_pool_t *pool;
+    big_int_rsa_key_t *key;
+
+    e = big_int_new_from_int(65537);
+    pool = big_int_worker_pool_new(1);
+    key = big_int_rsa_keygen(length, e, pool);
+    if (pool != NULL) big_int_worker_pool_destroy(pool);
+    big_int_destroy(e);
+    return key;
+}
+
+int rsa_keygen(size_t length)
+{
+    big_int_rsa_key_t *key;
+
+    key = rsa_keygen_on_pool(length);
+    if (key == NULL)
+    {
+        printf("error: key generation failed (length >= %d)\n", BIG_INT_RSA_BITS_MIN);
+        return -1;
+    }
+    printf("n="); big_int_print(key->n); printf("\n");
+    printf("e="); big_int_print(key->e); printf("\n");
+    printf("d="); big_int_print(key->d); printf("\n");
+    printf("p="); big_int_print(key->p); printf("\n");
+    printf("q="); big_int_print(key->q); printf("\n");
+    printf("dp="); big_int_print(key->dp); printf("\n");
+    printf("dq="); big_int_print(key->dq); printf("\n");
+    printf("qinv="); big_int_print(key->qinv); printf("\n");
+    fflush(stdout);
+    big_int_rsa_key_destroy(key);
+
+    return 0;
+}
+
+
+/* RSA private operation with CRT against c ^ d mod n */
+#define RSA_BENCH_ROUNDS 20
+int rsa_bench(size_t length)
+{
+    int idx, mismatch = 0;
+    clock_t start;
+    double crt_ms, plain_ms;
+    big_int_rsa_key_t *key;
+    big_int_t *c[RSA_BENCH_ROUNDS];
+    big_int_t *m_crt, *m_plain;
+
+    start = clock();
+    key = rsa_keygen_on_pool(length);
+    if (key == NULL)
+    {
+        printf("error: key generation failed (length >= %d)\n", BIG_INT_RSA_BITS_MIN);
+        return -1;
+    }
+    printf("keygen: %.3f ms cpu\n", (double)(clock() - start) * 1000 / CLOCKS_PER_SEC);
+    for (idx = 0; idx != RSA_BENCH_ROUNDS; idx++)
+    {
+        c[idx] = big_int_new_random(length);
+        big_int_mod_to(c[idx], key->n);
+    }
+    m_crt = big_int_new_from_int(0);
+    m_plain = big_int_new_from_int(0);
+
+    start = clock();
+    for (idx = 0; idx != RSA_BENCH_ROUNDS; idx++) big_int_rsa_private(key, m_crt, c[idx]);
+    crt_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC / RSA_BENCH_ROUNDS;
+
+    start = clock();
+    for (idx = 0; idx != RSA_BENCH_ROUNDS; idx++) big_int_powm(m_plain, c[idx], key->d, key->n);
+    plain_ms = (double)(clock() - start) * 1000 / CLOCKS_PER_SEC / RSA_BENCH_ROUNDS;
+
+    for (idx = 0; idx != RSA_BENCH_ROUNDS; idx++)
+    {
+        big_int_rsa_private(key, m_crt, c[idx]);
+        big_int_powm(m_plain, c[idx], key->d, key->n);
+        if (big_int_compare(m_crt, m_plain) != 0) mismatch++;
+        big_int_destroy(c[idx]);
+    }
+    printf("private (crt)  : %.3f ms\n", crt_ms);
+    printf("private (plain): %.3f ms\n", plain_ms);
+    printf("speedup        : %.2fx\n", plain_ms / crt_ms);
+    if (mismatch != 0) printf("error: %d results differ\n", mismatch);
+    fflush(stdout);
+
+    big_int_destroy(m_crt);
+    big_int_destroy(m_plain);
+    big_int_rsa_key_destroy(key);
+
+    return mismatch == 0 ? 0 : -1;
+}
+
+
 /* nth item in fibonacci array */
 int fibonacci_nth(int idx)
 {
@@ -241,6 +368,19 @@ int fibonacci_nth(int idx)
     return 0;
 }
 
+int factorial(int n)
+{
+    big_int_t *num;
+
+    if (n < 0) { show_help(); return -1; }
+    num = big_int_new_from_int(0);
+    big_int_fac(num, (unsigned int)n);
+    big_int_print(num); printf("\n");
+    big_int_destroy(num);
+
+    return 0;
+}
+
 
 int main(int argc, const char *argv[])
 {
@@ -323,6 +463,17 @@ int main(int argc, const char *argv[])
             mod_op(s_num1, s_num2);
         }
     }
+    else if (argsparse_match_str(&argsparse, "sqrt"))
+    {
+        argsparse_next(&argsparse);
+        if (argsparse_available(&argsparse) == 0)
+        { show_help(); goto done; }
+        else
+        { 
+            s_num1 = argsparse_fetch(&argsparse); 
+            sqrt_op(s_num1);
+        }
+    }
     else if (argsparse_match_str(&argsparse, "random"))
     {
         argsparse_next(&argsparse);
@@ -350,6 +501,24 @@ int main(int argc, const char *argv[])
         { s_length = argsparse_fetch(&argsparse); }
         dh(atoi(s_length));
     }
+    else if (argsparse_match_str(&argsparse, "rsa-keygen"))
+    {
+        argsparse_next(&argsparse);
+        if (argsparse_available(&argsparse) == 0)
+        { show_help(); goto done; }
+        else
+        { s_length = argsparse_fetch(&argsparse); }
+        rsa_keygen(atoi(s_length));
+    }
+    else if (argsparse_match_str(&argsparse, "rsa-bench"))
+    {
+        argsparse_next(&argsparse);
+        if (argsparse_available(&argsparse) == 0)
+        { show_help(); goto done; }
+        else
+        { s_length = argsparse_fetch(&argsparse); }
+        rsa_bench(atoi(s_length));
+    }
     else if (argsparse_match_str(&argsparse, "fib"))
     { 
         argsparse_next(&argsparse);
@@ -359,6 +528,15 @@ int main(int argc, const char *argv[])
         { s_index = argsparse_fetch(&argsparse); }
         fibonacci_nth(atoi(s_index));
     }
+    else if (argsparse_match_str(&argsparse, "fac"))
+    { 
+        argsparse_next(&argsparse);
+        if (argsparse_available(&argsparse) == 0)
+        { show_help(); goto done; }
+        else
+        { s_index = argsparse_fetch(&argsparse); }
+        factorial(atoi(s_index));
+    }
     else
     { show_help(); goto done; }
 